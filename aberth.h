@@ -0,0 +1,290 @@
+// Ehrlich-Aberth simultaneous iteration.
+//
+// All N approximations are refined together: with the Newton correction r = p(z_i)/p'(z_i)
+// the update is
+//
+//   z_i <- z_i - r/(1 - r*sum_(j != i) 1/(z_i - z_j))
+//
+// applied in Gauss-Seidel order. The iteration only needs p and p' at the current
+// approximations, so a sparse polynomial is iterated on its terms without ever forming the
+// dense coefficient vector. Approximations that have converged are locked and no longer
+// evaluated.
+//
+// The approximations start on circles with the root moduli estimated by RootModuli, as
+// many on each circle as the Newton polygon puts roots there, so that roots spread over
+// many orders of magnitude do not all have to travel from one common circle.
+
+#include <cmath>
+#include <cfloat>
+#include <complex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "rpoly.h"
+#include "sparse.h"
+#include "moduli.h"
+
+#ifndef Aberth_h
+#define Aberth_h
+
+class Aberth: public RPoly {
+  int maxDegree;
+  int mdp1;
+
+  public:
+    Aberth(int degree, int maxIter = 500);
+    ~Aberth(void);
+
+    void initialize() override;
+    const char* name(void) const override { return "aberth"; };
+    void rpoly(double* op, int Degree, double* zeror, double* zeroi) override;
+    void rpolySparse(const SparsePoly& poly, double* op, double* zeror, double* zeroi) override;
+    RootStatus solve(double* op, int Degree, double* zeror, double* zeroi, int* found) noexcept override;
+
+  protected:
+    int maxIter;
+    std::complex<double>* z{nullptr};
+    bool* done{nullptr};
+    bool* keep{nullptr};
+    RootModuli moduli;
+    std::vector<double> radius;
+
+    void start(int N);
+    void realify(int N, double* zeror, double* zeroi);
+    int converged(int N, double* zeror, double* zeroi);
+
+  private:
+    // Dense coefficients evaluated by Horner's rule
+    class Dense {
+      public:
+        Dense(const double* op, int N) : op(op), N(N) {};
+        int degree(void) const { return N; };
+        double coefficient(int j) const { return op[j]; };
+        void evaluate(std::complex<double> x, std::complex<double>& px, std::complex<double>& dpx) const;
+        double bound(double r) const;
+      private:
+        const double* op;
+        int N;
+    };
+
+    template<class Poly> int iterate(const Poly& poly, int N, double* zeror, double* zeroi);
+};
+
+inline Aberth::Aberth(int degree, int maxIter) : RPoly(degree), maxIter(maxIter) {
+  maxDegree = degree;
+  mdp1 = degree + 1;
+  z    = new std::complex<double>[maxDegree];
+  done = new bool[maxDegree];
+  keep = new bool[maxDegree];
+}
+
+inline Aberth::~Aberth(void) {
+  delete [] z;
+  delete [] done;
+  delete [] keep;
+  z    = nullptr;
+  done = nullptr;
+  keep = nullptr;
+}
+
+inline void Aberth::initialize() {}
+
+inline void Aberth::Dense::evaluate(std::complex<double> x, std::complex<double>& px, std::complex<double>& dpx) const {
+  px  = op[0];
+  dpx = 0.0;
+  for (int i = 1; i <= N; i++){
+    dpx = dpx*x + px;
+    px  = px*x + op[i];
+  }
+}
+
+inline double Aberth::Dense::bound(double r) const {
+  double b = fabs(op[0]);
+  for (int i = 1; i <= N; i++)   b = b*r + fabs(op[i]);
+  return b;
+}
+
+inline void Aberth::rpoly(double op[], int Degree, double zeror[], double zeroi[]) {
+  int found;
+  switch (solve(op, Degree, zeror, zeroi, &found)) {
+    case RootStatus::DegreeTooLarge:
+      throw std::invalid_argument( "Requested maximal degree is greater than MAXDEGREE." );
+    case RootStatus::LeadingCoefficientZero:
+      throw std::invalid_argument( "The leading coefficient is zero." );
+    case RootStatus::NoConvergence:
+      throw std::runtime_error( "Failure to converge after the maximal number of Aberth iterations." );
+    default:
+      break;
+  }
+}
+
+inline RootStatus Aberth::solve(double op[], int Degree, double zeror[], double zeroi[], int* found) noexcept {
+  *found = 0;
+  if (Degree > maxDegree)   return RootStatus::DegreeTooLarge;
+  if (op[0] == 0.0)         return RootStatus::LeadingCoefficientZero;
+
+  // Remove zeros at the origin, if any
+  int N = Degree;
+  int j = 0;
+  while (N > 0 && op[N] == 0.0){
+    zeror[j] = zeroi[j] = 0.0;
+    N--;
+    j++;
+  }
+
+  if (N > 0){
+    Dense poly(op, N);
+    int n;
+    try {
+      moduli.estimate(op, N, radius);
+      n = iterate(poly, N, &zeror[j], &zeroi[j]);
+    }
+    catch (...) {
+      // Out of memory for the estimates
+      *found = j;
+      return RootStatus::NoConvergence;
+    }
+    if (n < N){
+      *found = j + n;
+      return RootStatus::NoConvergence;
+    }
+  }
+
+  *found = Degree;
+  return RootStatus::Success;
+}
+
+inline void Aberth::rpolySparse(const SparsePoly& sparse, double* op, double* zeror, double* zeroi) {
+  int Degree = sparse.degree();
+  if (Degree > maxDegree){
+    throw std::invalid_argument( "Requested maximal degree is greater than MAXDEGREE." );
+  }
+  if (sparse.coefficient(0) == 0.0){
+    throw std::invalid_argument( "The leading coefficient is zero." );
+  }
+
+  // Remove zeros at the origin, if any
+  int m = sparse.valuation();
+  for (int j = 0; j < m; j++)   zeror[j] = zeroi[j] = 0.0;
+  int N = Degree - m;
+  if (N == 0)   return;
+
+  SparsePoly poly;
+  sparse.shift(m, poly);
+  moduli.estimate(poly, radius);
+  if (iterate(poly, N, &zeror[m], &zeroi[m]) < N){
+    throw std::runtime_error( "Failure to converge after the maximal number of Aberth iterations." );
+  }
+}
+
+// Returns the number of roots found. On failure to converge the roots found are moved to
+// the front of zeror, zeroi.
+template<class Poly> int Aberth::iterate(const Poly& poly, int N, double* zeror, double* zeroi) {
+  std::complex<double> pz, dpz;
+
+  start(N);
+
+  int active = N;
+  for (int it = 0; it < maxIter && active > 0; it++){
+    for (int i = 0; i < N; i++){
+      if (done[i])   continue;
+
+      poly.evaluate(z[i], pz, dpz);
+
+      // Converged if p(z) is at the level of its rounding error
+      double az = std::abs(z[i]);
+      if (std::abs(pz) <= N*DBL_EPSILON*poly.bound(az)){
+        done[i] = true;
+        active--;
+        continue;
+      }
+
+      std::complex<double> sum = 0.0;
+      for (int j = 0; j < N; j++){
+        if (j != i)   sum += 1.0/(z[i] - z[j]);
+      }
+
+      std::complex<double> w;
+      if (dpz == 0.0){
+        // Stationary point: nudge the approximation off it
+        w = std::polar((az > 0.0 ? az : 1.0)*sqrt(DBL_EPSILON), 1.0 + i);
+      }
+      else {
+        std::complex<double> r = pz/dpz;
+        w = r/(1.0 - r*sum);
+      }
+      z[i] -= w;
+
+      if (std::abs(w) <= 2.0*DBL_EPSILON*std::abs(z[i]) + atol + rtol*std::abs(z[i])){
+        done[i] = true;
+        active--;
+      }
+    }
+  }
+
+  realify(N, zeror, zeroi);
+  return ((active > 0) ? converged(N, zeror, zeroi) : N);
+}
+
+// Spread the approximations evenly over each circle of the estimated moduli in radius. The
+// offsets 2 pi i/N between circles and 0.4 avoid starting on the real axis, where conjugate
+// roots cannot separate.
+inline void Aberth::start(int N) {
+  const double pi = 3.14159265358979323846;
+  for (int i = 0; i < N; ){
+    int c = i + 1;
+    while (c < N && radius[c] == radius[i])   c++;
+    for (int k = i; k < c; k++){
+      z[k] = std::polar(radius[k], 2.0*pi*(k - i)/(c - i) + 2.0*pi*i/N + 0.4);
+      done[k] = false;
+    }
+    i = c;
+  }
+}
+
+// The coefficients are real, so a root whose imaginary part is at the noise level and
+// that has no conjugate partner among the other roots is real.
+inline void Aberth::realify(int N, double* zeror, double* zeroi) {
+  for (int i = 0; i < N; i++){
+    zeror[i] = z[i].real();
+    zeroi[i] = z[i].imag();
+    double im = fabs(zeroi[i]);
+    if (im > sqrt(DBL_EPSILON)*std::abs(z[i]))   continue;
+
+    bool partner = false;
+    for (int j = 0; j < N && !partner; j++){
+      if (j != i && std::abs(z[j] - std::conj(z[i])) < im)   partner = true;
+    }
+    if (!partner)   zeroi[i] = 0.0;
+  }
+}
+
+// Move the converged roots to the front. A non-real root only counts together with its
+// converged conjugate, so the roots not found are those of a real polynomial.
+inline int Aberth::converged(int N, double* zeror, double* zeroi) {
+  for (int i = 0; i < N; i++)   keep[i] = (done[i] && zeroi[i] == 0.0);
+
+  for (int i = 0; i < N; i++){
+    if (!done[i] || zeroi[i] <= 0.0)   continue;
+    for (int j = 0; j < N; j++){
+      if (done[j] && !keep[j] && zeroi[j] < 0.0
+          && std::abs(z[j] - std::conj(z[i])) <= sqrt(DBL_EPSILON)*std::abs(z[i])){
+        keep[i] = keep[j] = true;
+        break;
+      }
+    }
+  }
+
+  int k = 0;
+  for (int i = 0; i < N; i++){
+    if (!keep[i])   continue;
+    std::swap(zeror[i], zeror[k]);
+    std::swap(zeroi[i], zeroi[k]);
+    std::swap(keep[i], keep[k]);
+    k++;
+  }
+  return k;
+}
+
+#endif
@@ -0,0 +1,261 @@
+#include "gmock/gmock.h"
+
+#include "rpoly.h"
+#include "aberth.h"
+#include "akiti.h"
+#include "roots.h"
+#include "sparse.h"
+#include "moduli.h"
+#include "helper.h"
+
+#include <vector>
+#include <complex>
+#include <stdexcept>
+#include <algorithm>
+
+using namespace testing;
+
+class SimultaneousIteration: public Test {
+  public:
+    RPoly* aberth{nullptr};
+    RPoly* akiti{nullptr};
+    SparsePoly trinomial;
+
+    void SetUp() override {
+      aberth = new Aberth(1000);
+      akiti  = new Akiti(1000);
+      // x^1000 - 3x^17 + 1
+      trinomial.addTerm(17, -3.0);
+      trinomial.addTerm(1000, 1.0);
+      trinomial.addTerm(0, 1.0);
+    }
+
+    void TearDown() override {
+      delete aberth;
+      aberth = nullptr;
+      delete akiti;
+      akiti = nullptr;
+    }
+};
+
+TEST_F(SimultaneousIteration, SparseTermsAreOrderedByDecreasingExponent) {
+  EXPECT_THAT(trinomial.degree(), Eq(1000));
+  EXPECT_THAT(trinomial.terms(), Eq(3));
+  EXPECT_THAT(trinomial.exponent(1), Eq(17));
+  EXPECT_THAT(trinomial.coefficient(1), Eq(-3.0));
+}
+
+TEST_F(SimultaneousIteration, SparseTermsThatCancelAreDropped) {
+  trinomial.addTerm(17, 3.0);
+  EXPECT_THAT(trinomial.terms(), Eq(2));
+}
+
+TEST_F(SimultaneousIteration, SparseHornerEvaluation) {
+  EXPECT_THAT(trinomial.evaluate(1.0), Eq(-1.0));
+  EXPECT_THAT(trinomial.evaluate(-1.0), Eq(5.0));
+
+  std::complex<double> pz, dpz;
+  trinomial.evaluate(std::complex<double>(0.0, 1.0), pz, dpz);
+  // i^1000 = 1, i^17 = i, i^999 = -i, i^16 = 1
+  EXPECT_THAT(pz.real(), DoubleEq(2.0));
+  EXPECT_THAT(pz.imag(), DoubleEq(-3.0));
+  EXPECT_THAT(dpz.real(), DoubleEq(-51.0));
+  EXPECT_THAT(dpz.imag(), DoubleEq(-1000.0));
+}
+
+TEST_F(SimultaneousIteration, DensifyPlacesLeadingCoefficientFirst) {
+  SparsePoly p;
+  p.addTerm(3, 2.0);
+  p.addTerm(1, -1.0);
+  double op[4];
+  p.densify(op);
+  EXPECT_THAT(op[0], Eq(2.0));
+  EXPECT_THAT(op[1], Eq(0.0));
+  EXPECT_THAT(op[2], Eq(-1.0));
+  EXPECT_THAT(op[3], Eq(0.0));
+}
+
+TEST_F(SimultaneousIteration, DenseAberthAgreesWithAkiti) {
+  Roots rootfinder(aberth);
+  std::vector<double> coeff = {0.001388888888889, 0.008333333333333, 0.0, 0.0, 0.0, 0.0, -0.000000010000000};
+  rootfinder.findRoots(coeff);
+
+  Helper helper;
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMinPosRealRoot(), 0.065297428539350, 100));
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMinNegRealRoot(), -6.000000000925208, 100));
+}
+
+TEST_F(SimultaneousIteration, SparseRootsOfUnity) {
+  Roots rootfinder(aberth);
+  SparsePoly p;
+  p.addTerm(100, 1.0);
+  p.addTerm(0, -1.0);
+  rootfinder.findRoots(p);
+
+  int degree;
+  std::vector<double> zr, zi;
+  rootfinder.getRoots(degree, zr, zi);
+  EXPECT_THAT(degree, Eq(100));
+  for(int j=0; j<degree; j++) {
+    EXPECT_THAT(std::hypot(zr[j], zi[j]), DoubleNear(1.0, 1e-14));
+  }
+
+  int nRealRoot;
+  std::vector<double> real;
+  rootfinder.getRoots(nRealRoot, real);
+  EXPECT_THAT(nRealRoot, Eq(2));
+  EXPECT_THAT(rootfinder.getMaxPosRealRoot(), DoubleNear(1.0, 1e-15));
+  EXPECT_THAT(rootfinder.getMaxNegRealRoot(), DoubleNear(-1.0, 1e-15));
+}
+
+TEST_F(SimultaneousIteration, SparseTrinomialOfDegreeOneThousand) {
+  Roots rootfinder(aberth);
+  rootfinder.findRoots(trinomial);
+
+  int degree;
+  std::vector<double> zr, zi;
+  rootfinder.getRoots(degree, zr, zi);
+  for(int j=0; j<degree; j++) {
+    std::complex<double> pz, dpz, z(zr[j], zi[j]);
+    trinomial.evaluate(z, pz, dpz);
+    EXPECT_THAT(std::abs(pz), Le(1e-10*trinomial.bound(std::abs(z))));
+  }
+
+  int nRealRoot;
+  std::vector<double> real;
+  rootfinder.getRoots(nRealRoot, real);
+  EXPECT_THAT(nRealRoot, Eq(2));
+  EXPECT_THAT(std::fabs(trinomial.evaluate(rootfinder.getMinPosRealRoot())), Lt(1e-13));
+}
+
+TEST_F(SimultaneousIteration, SparseZerosAtOrigin) {
+  Roots rootfinder(aberth);
+  SparsePoly p;
+  p.addTerm(5, 1.0);
+  p.addTerm(2, -8.0);
+  rootfinder.findRoots(p);
+
+  int degree;
+  std::vector<double> zr, zi;
+  rootfinder.getRoots(degree, zr, zi);
+  EXPECT_THAT(zr[0], Eq(0.0));
+  EXPECT_THAT(zr[1], Eq(0.0));
+  EXPECT_THAT(rootfinder.getMaxPosRealRoot(), DoubleNear(2.0, 1e-15));
+}
+
+TEST_F(SimultaneousIteration, SparseInputDensifiedForAkiti) {
+  Roots rootfinder(akiti);
+  SparsePoly p;
+  p.addTerm(3, 1.0);
+  p.addTerm(0, -8.0);
+  rootfinder.findRoots(p);
+
+  Helper helper;
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMaxPosRealRoot(), 2.0, 10));
+}
+
+TEST_F(SimultaneousIteration, SparseExceedingMaximalDegree) {
+  Aberth small(10);
+  Roots rootfinder(&small);
+  try {
+    rootfinder.findRoots(trinomial);
+    FAIL() << "Expected std::invalid_argument";
+  }
+  catch (const std::invalid_argument& expected) {
+    ASSERT_STREQ(expected.what(), "Requested maximal degree is greater than MAXDEGREE.");
+  }
+}
+
+TEST_F(SimultaneousIteration, SolveKeepsPartialRootsAndRemainder) {
+  Aberth few(10, 7);
+  Roots rootfinder(&few);
+  // (x-1)(x-2)(x-3)(x-4)(x-5)(x-6)
+  std::vector<double> coeff = {1, -21, 175, -735, 1624, -1764, 720};
+
+  int found;
+  EXPECT_TRUE(rootfinder.solve(coeff, found) == RootStatus::NoConvergence);
+  EXPECT_THAT(found, Lt(6));
+
+  int degree;
+  std::vector<double> zr, zi, rem;
+  rootfinder.getRoots(degree, zr, zi);
+  rootfinder.getRemainder(rem);
+  EXPECT_THAT((int)rem.size() - 1, Eq(degree - found));
+
+  // Re-solve the remainder with another backend
+  Roots other(akiti);
+  other.findRoots(rem);
+  std::vector<double> all, rest;
+  int nReal;
+  rootfinder.getRoots(nReal, all);
+  all.resize(nReal);
+  other.getRoots(nReal, rest);
+  rest.resize(nReal);
+  all.insert(all.end(), rest.begin(), rest.end());
+  std::sort(all.begin(), all.end());
+  ASSERT_THAT(all.size(), Eq(6u));
+  for(int j=0; j<6; j++) {
+    EXPECT_THAT(all[j], DoubleNear(j + 1.0, 1e-8));
+  }
+}
+
+TEST_F(SimultaneousIteration, RootModuliOfWidelySpreadRoots) {
+  // Roots 10^k for k = -6, ..., 6
+  std::vector<double> coeff(1, 1.0);
+  for(int k=-6; k<=6; k++) {
+    std::vector<double> next(coeff.size() + 1, 0.0);
+    for(size_t i=0; i<coeff.size(); i++) {
+      next[i] += coeff[i];
+      next[i + 1] -= pow(10.0, k)*coeff[i];
+    }
+    coeff = next;
+  }
+
+  RootModuli moduli;
+  std::vector<double> radius;
+  moduli.estimate(coeff.data(), 13, radius);
+  ASSERT_THAT(radius.size(), Eq(13u));
+  for(int j=0; j<13; j++) {
+    EXPECT_THAT(radius[j]/pow(10.0, j - 6), AllOf(Ge(0.5), Le(2.0)));
+  }
+
+  // Started on these circles, Aberth needs few iterations
+  Aberth few(13, 10);
+  std::vector<double> zr(13), zi(13);
+  int found;
+  EXPECT_TRUE(few.solve(coeff.data(), 13, zr.data(), zi.data(), &found) == RootStatus::Success);
+  std::sort(zr.begin(), zr.end());
+  for(int j=0; j<13; j++) {
+    EXPECT_THAT(zr[j], DoubleNear(pow(10.0, j - 6), 1e-12*pow(10.0, j - 6)));
+  }
+}
+
+TEST_F(SimultaneousIteration, RootModuliFromSparseTerms) {
+  RootModuli moduli;
+  std::vector<double> radius;
+  moduli.estimate(trinomial, radius);
+  ASSERT_THAT(radius.size(), Eq(1000u));
+  // The polygon of x^1000 - 3x^17 + 1 has 17 roots of modulus 3^(-1/17), 983 of 3^(1/983)
+  EXPECT_THAT(radius[0], DoubleNear(pow(3.0, -1.0/17), 1e-14));
+  EXPECT_THAT(radius[16], DoubleNear(pow(3.0, -1.0/17), 1e-14));
+  EXPECT_THAT(radius[17], DoubleNear(pow(3.0, 1.0/983), 1e-14));
+  EXPECT_THAT(radius[999], DoubleNear(pow(3.0, 1.0/983), 1e-14));
+
+  SparsePoly p;
+  p.addTerm(5, 1.0);
+  p.addTerm(2, -8.0);
+  moduli.estimate(p, radius);
+  EXPECT_THAT(radius, ElementsAre(0.0, 0.0, DoubleNear(2.0, 1e-15), DoubleNear(2.0, 1e-15), DoubleNear(2.0, 1e-15)));
+}
+
+TEST_F(SimultaneousIteration, LazyRootsFromSimultaneousSolveAreSorted) {
+  Roots rootfinder(aberth);
+  // (x-0.5)(x+4)(x^2+x+1)
+  std::vector<double> c = {1, 4.5, 2.5, 1.5, -2};
+  rootfinder.beginRoots(c);
+  double x, y;
+  std::vector<double> modulus;
+  while(rootfinder.nextRoot(x, y)) modulus.push_back(std::hypot(x, y));
+  EXPECT_THAT(modulus, ElementsAre(DoubleNear(0.5, 1e-12), DoubleNear(1.0, 1e-12),
+                                   DoubleNear(1.0, 1e-12), DoubleNear(4.0, 1e-12)));
+}
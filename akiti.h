@@ -32,14 +32,55 @@
 #include <cmath>
 #include <cfloat>
 #include <stdexcept>
+#include <random>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <climits>
 
 #include "rpoly.h"
+#include "moduli.h"
+#include "kernels.h"
+#include "trace.h"
 
 using namespace std;
 
 #ifndef Akiti_h
 #define Akiti_h
 
+// Schedule of the shifts tried for each zero. The defaults are those of RPOLY.FOR: up to 20
+// shifts rotated by 94 degrees, where the k-th shift gets 20*k fixed shift steps.
+//
+// In adaptive mode a shift is abandoned as soon as neither the s nor the v sequence of
+// Fxshfr has decreased for stagnationSteps steps, and a shift whose sequences are still
+// converging when its budget runs out is extended by the number of steps the observed
+// rate of convergence predicts, at most doubling the budget. Randomized restarts draw the
+// angle of every shift after the first from a generator seeded with seed at the start of
+// every solve, so the roots of a polynomial do not depend on what the workspace solved before.
+//
+// With parallelShifts > 1 the shifts after the first failed one are tried speculatively on
+// that many threads at once, each on its own copy of the K polynomial. When a shift
+// converges, the attempts at later shifts are cancelled; earlier ones still running are
+// finished, so the shift taken, and with it the roots, are those of the serial schedule.
+//
+// With moduliRadius the first shift for the k-th zero lies on the circle of the k-th smallest
+// root modulus estimated by RootModuli, when that is above the Cauchy lower bound. Zeros
+// are mostly found in order of increasing modulus, so the shift starts close to the zero
+// wanted. Should it fail, the zero may lie on that very circle, and the other shifts fall
+// back to the Cauchy lower bound.
+struct ShiftStrategy {
+  int maxShifts{20};
+  int firstSteps{20};
+  int stepGrowth{20};
+  bool adaptive{false};
+  int stagnationSteps{5};
+  bool randomRestarts{false};
+  unsigned seed{1};
+  int parallelShifts{1};
+  bool moduliRadius{false};
+};
+
 class Akiti: public RPoly {
   int maxDegree;
   int mdp1;
@@ -49,9 +90,49 @@ class Akiti: public RPoly {
     ~Akiti(void);
 
     void initialize() override;
+    const char* name(void) const override { return "akiti"; };
     void rpoly(double* op, int Degree, double* zeror, double* zeroi) override;
+    RootStatus solve(double* op, int Degree, double* zeror, double* zeroi, int* found) noexcept override;
+    RootStatus begin(double* op, int Degree, double* zeror, double* zeroi) noexcept override;
+    RootStatus next(int* found) noexcept override;
+    void setShiftStrategy(const ShiftStrategy& strategy);
+    int getShiftCount(void) const;
+    int getStepCount(void) const;
+    int getIterationCount(void) const;
 
   private:
+    ShiftStrategy strategy;
+    std::mt19937 rng;
+    RootModuli moduli;
+    std::vector<double> radius;
+    // Versions of the inner loops for the instruction set of the processor
+    const Kernels* kernels;
+    std::atomic<int> shiftCount{0};
+    std::atomic<int> stepCount{0};
+    std::atomic<int> iterCount{0};
+
+    // State of a lazy solve between deflations: the degree of the current p and the
+    // direction of the last shift
+    struct Deflation {
+      int degree{0};
+      int N{0};
+      int NN{0};
+      double xx{0.0}, yy{0.0};
+      double* zeror{nullptr};
+      double* zeroi{nullptr};
+    } run;
+
+    // Lowest shift that has converged among the speculative attempts; later ones stop
+    std::atomic<int> winner{INT_MAX};
+
+    // Private copies of the K polynomial and work arrays of one speculative attempt
+    struct Attempt {
+      std::vector<double> K, qp, qk, svk;
+      int shift{0};
+      int NZ{0};
+      double lzi{0.0}, lzr{0.0}, szi{0.0}, szr{0.0};
+    };
+
     double* K{nullptr};
     double* p{nullptr};
     double* pt{nullptr};
@@ -60,11 +141,17 @@ class Akiti: public RPoly {
     double* qk{nullptr};
     double* svk{nullptr};
 
+    RootStatus deflate(void);
     void Quad(double a, double b1, double c, double* sr, double* si, double* lr, double* li);
 
     void Fxshfr(int L2, int* NZ, double sr, double bnd, double* K, int N, double* p, int NN, double* qp,
+                    double* lzi, double* lzr, double* szi, double* szr, double* qk, double* svk, int shift);
+
+    int parallelFxshfr(int first, int* NZ, double bnd, double* xx, double* yy, int N, int NN,
                     double* lzi, double* lzr, double* szi, double* szr);
 
+    void nextAngle(int jj, double* xx, double* yy);
+
     void QuadSD(int NN, double u, double v, double* p, double* q, double* a, double* b);
 
     int calcSC(int N, double a, double b, double* a1, double* a3, double* a7, double* c, double* d,
@@ -84,7 +171,7 @@ class Akiti: public RPoly {
                     double* szi, double* K, double* qk);
 };
 
-Akiti::Akiti(int degree) : RPoly(degree) {
+inline Akiti::Akiti(int degree) : RPoly(degree), kernels(&Kernels::active()) {
   maxDegree = degree;
   mdp1 = degree + 1;
   K     = new double[mdp1];
@@ -96,7 +183,7 @@ Akiti::Akiti(int degree) : RPoly(degree) {
   svk   = new double[mdp1];
 }
 
-Akiti::~Akiti(void) {
+inline Akiti::~Akiti(void) {
   delete [] K;
   delete [] p;
   delete [] pt;
@@ -113,32 +200,79 @@ Akiti::~Akiti(void) {
   svk  = nullptr;
 }
 
-void Akiti::initialize() {}
+inline void Akiti::initialize() {}
 
-void Akiti::rpoly(double op[], int Degree, double zeror[], double zeroi[]) {
+inline void Akiti::setShiftStrategy(const ShiftStrategy& s) {
+  strategy = s;
+  rng.seed(strategy.seed);
+}
 
-int i, j, jj, l, N, NM1, NN, NZ, zerok;
+// Shifts tried and fixed shift steps taken by the last solve
+inline int Akiti::getShiftCount(void) const {
+  return shiftCount;
+}
 
-// double K[MDP1], p[MDP1], pt[MDP1], qp[MDP1], temp[MDP1];
-double bnd, df, dx, factor, ff, moduli_max, moduli_min, sc, x, xm;
-double aa, bb, cc, lzi, lzr, sr, szi, szr, t, xx, xxx, yy;
+inline int Akiti::getStepCount(void) const {
+  return stepCount;
+}
 
-const double RADFAC = 3.14159265358979323846/180; // Degrees-to-radians conversion factor = pi/180
-const double lb2 = log(2.0); // Dummy variable to avoid re-calculating this value in loop below
-const double lo = FLT_MIN/DBL_EPSILON;
-const double cosr = cos(94.0*RADFAC); // = -0.069756474
-const double sinr = sin(94.0*RADFAC); // = 0.99756405
+// Variable shift iterations taken by QuadIT and RealIT in the last solve
+inline int Akiti::getIterationCount(void) const {
+  return iterCount;
+}
+
+inline void Akiti::rpoly(double op[], int Degree, double zeror[], double zeroi[]) {
+  int found;
+  switch (solve(op, Degree, zeror, zeroi, &found)) {
+    case RootStatus::DegreeTooLarge:
+      throw invalid_argument( "Requested maximal degree is greater than MAXDEGREE." );
+    case RootStatus::LeadingCoefficientZero:
+      throw invalid_argument( "The leading coefficient is zero." );
+    case RootStatus::NoConvergence:
+      throw runtime_error( "Failure to converge after 20 shifts." );
+    default:
+      break;
+  }
+}
+
+// The roots found before a failure to converge stay in zeror, zeroi: the zeros are
+// stored from the front as the polynomial is deflated, so *found = Degree - N of them
+// are valid.
+inline RootStatus Akiti::solve(double op[], int Degree, double zeror[], double zeroi[], int* found) noexcept {
+
+TraceScope trace(TracePoint::Rpoly, Degree);
+*found = 0;
+RootStatus status = begin(op, Degree, zeror, zeroi);
+while ((status == RootStatus::Success) && (*found < Degree))   status = next(found);
+return status;
+} // End solve
+
+// Lazy solve. begin removes the zeros at the origin and keeps a copy of the coefficients;
+// each next then hands out one zero at the origin or deflates the next zero or pair of
+// zeros, in the order the shifts find them. That is mostly the order of increasing
+// modulus, as the shifts start on a circle below the smallest remaining zero.
+inline RootStatus Akiti::begin(double op[], int Degree, double zeror[], double zeroi[]) noexcept {
+
+int i, j, N;
+
+shiftCount = stepCount = iterCount = 0;
+winner = INT_MAX;
+run.degree = run.N = 0;
+// Every solve draws the same angles, whatever the solves before it on this workspace
+rng.seed(strategy.seed);
 
 if (Degree > maxDegree){
-  throw invalid_argument( "Requested maximal degree is greater than MAXDEGREE." );
+  return RootStatus::DegreeTooLarge;
 } // End (Degree > MAXDEGREE)
 
 //Do a quick check to see if leading coefficient is 0
-if (op[0] != 0){
+if (op[0] == 0){
+  return RootStatus::LeadingCoefficientZero;
+} // End if (op[0] == 0)
 
 N = Degree;
-xx = sqrt(0.5); // = 0.70710678
-yy = -xx;
+run.xx = sqrt(0.5); // = 0.70710678
+run.yy = -run.xx;
 
 // Remove zeros at the origin, if any
 j = 0;
@@ -148,12 +282,67 @@ while (op[N] == 0){
     j++;
 } // End while (op[N] == 0)
 
-NN = N + 1;
+run.degree = Degree;
+run.N = N;
+run.NN = N + 1;
+run.zeror = zeror;
+run.zeroi = zeroi;
 
 // Make a copy of the coefficients
-for (i = 0; i < NN; i++)   p[i] = op[i];
+for (i = 0; i < run.NN; i++)   p[i] = op[i];
+
+// Estimated moduli of the zeros not at the origin, for the radius of the shifts
+radius.clear();
+if (strategy.moduliRadius){
+    try {
+        moduli.estimate(p, N, radius);
+    }
+    catch (...) {
+        // Out of memory: keep the Cauchy lower bound
+        radius.clear();
+    }
+} // End if (strategy.moduliRadius)
+
+return RootStatus::Success;
+} // End begin
+
+// *found is the number of zeros stored from the front of zeror, zeroi, and is advanced
+// past the ones this call finds
+inline RootStatus Akiti::next(int* found) noexcept {
+
+if (*found < run.degree - run.N){
+    (*found)++;
+    return RootStatus::Success;
+} // End if (*found < run.degree - run.N)
+
+if (run.N < 1)   return RootStatus::Success;
+
+RootStatus status = deflate();
+*found = run.degree - run.N;
+return status;
+} // End next
+
+// One pass of the main loop of RPOLY: find the next zero or pair of zeros of p and deflate
+inline RootStatus Akiti::deflate() {
+
+int i, j, jj, l, NM1, NZ, zerok;
+
+// double K[MDP1], p[MDP1], pt[MDP1], qp[MDP1], temp[MDP1];
+double bnd, df, dx, factor, ff, moduli_max, moduli_min, sc, x, xm;
+double aa, bb, cc, lzi, lzr, sr, szi, szr, t;
+
+const double lb2 = log(2.0); // Dummy variable to avoid re-calculating this value in loop below
+const double lo = FLT_MIN/DBL_EPSILON;
+
+// The state kept between passes
+int& N = run.N;
+int& NN = run.NN;
+const int Degree = run.degree;
+double& xx = run.xx;
+double& yy = run.yy;
+double* zeror = run.zeror;
+double* zeroi = run.zeroi;
 
-while (N >= 1){ // Main loop
     // Start the algorithm for one zero
     if (N <= 2){
     // Calculate the final zero or pair of zeros
@@ -164,7 +353,9 @@ while (N >= 1){ // Main loop
         else { // else N == 2
             Quad(p[0], p[1], p[2], &zeror[Degree - 2], &zeroi[Degree - 2], &zeror[Degree - 1], &zeroi[Degree - 1]);
         } // End else N == 2
-        break;
+        N = 0;
+        NN = 1;
+        return RootStatus::Success;
     } // End if (N <= 2)
 
     // Find the largest and smallest moduli of the coefficients
@@ -238,6 +429,7 @@ while (N >= 1){ // Main loop
     } // End while loop
 
     bnd = x;
+    if (!radius.empty() && (radius[radius.size() - N] > bnd))   bnd = radius[radius.size() - N];
 
     // Compute the derivative as the initial K polynomial and do 5 steps with no shift
 
@@ -278,20 +470,33 @@ while (N >= 1){ // Main loop
 
     // Loop to select the quadratic corresponding to each new shift
 
-    for (jj = 1; jj <= 20; jj++){
+    for (jj = 1; jj <= strategy.maxShifts; jj++){
+
+        // A first shift on the estimated modulus has failed: the zero may lie on that
+        // circle, so go back to the Cauchy lower bound for the others
+        if (jj == 2)   bnd = x;
+
+        if ((jj > 1) && (strategy.parallelShifts > 1)){
 
-        // Quadratic corresponds to a double shift to a non-real point and its
-        // complex conjugate. The point has modulus BND and amplitude rotated
-        // by 94 degrees from the previous shift.
+            // The first shift has failed, so this zero is a hard one: try the remaining
+            // shifts speculatively in parallel. jj becomes the shift that converged, or
+            // maxShifts if none did.
 
-        xxx = -(sinr*yy) + cosr*xx;
-        yy = sinr*xx + cosr*yy;
-        xx = xxx;
-        sr = bnd*xx;
+            jj = parallelFxshfr(jj, &NZ, bnd, &xx, &yy, N, NN, &lzi, &lzr, &szi, &szr);
+        } // End if ((jj > 1) && (strategy.parallelShifts > 1))
+        else {
 
-        // Second stage calculation, fixed quadratic
+            // Quadratic corresponds to a double shift to a non-real point and its
+            // complex conjugate. The point has modulus BND.
 
-        Fxshfr(20*jj, &NZ, sr, bnd, K, N, p, NN, qp, &lzi, &lzr, &szi, &szr);
+            nextAngle(jj, &xx, &yy);
+            sr = bnd*xx;
+
+            // Second stage calculation, fixed quadratic
+
+            shiftCount++;
+            Fxshfr(strategy.firstSteps + strategy.stepGrowth*(jj - 1), &NZ, sr, bnd, K, N, p, NN, qp, &lzi, &lzr, &szi, &szr, qk, svk, jj);
+        } // End else
 
         if (NZ != 0){
 
@@ -319,25 +524,132 @@ while (N >= 1){ // Main loop
 
     } // End for jj
 
-    // Return with failure if no convergence with 20 shifts
+    // Return with failure if no convergence with maxShifts shifts
 
-    if (jj > 20) {
-      Degree -= N;
-      throw runtime_error( "Failure to converge after 20 shifts." );
-    } // End if (jj > 20)
+    if (jj > strategy.maxShifts) {
+      return RootStatus::NoConvergence;
+    } // End if (jj > strategy.maxShifts)
 
-} // End while (N >= 1)
 
-} // End if op[0] != 0
-else { // else op[0] == 0
-  Degree = 0;
-  throw invalid_argument( "The leading coefficient is zero." );
-} // End else op[0] == 0
+return RootStatus::Success;
+} // End deflate
+
+// Direction (xx, yy) of shift jj: the previous one rotated by 94 degrees, or drawn at
+// random on a restart.
+inline void Akiti::nextAngle(int jj, double* xx, double* yy) {
+
+const double RADFAC = 3.14159265358979323846/180; // Degrees-to-radians conversion factor = pi/180
+const double cosr = cos(94.0*RADFAC); // = -0.069756474
+const double sinr = sin(94.0*RADFAC); // = 0.99756405
+std::uniform_real_distribution<double> uniform(0.0, 1.0);
+double t, xxx;
+
+if ((jj > 1) && strategy.randomRestarts){
+    t = 360.0*RADFAC*uniform(rng);
+    *xx = cos(t);
+    *yy = sin(t);
+} // End if ((jj > 1) && strategy.randomRestarts)
+else {
+    xxx = -(sinr*(*yy)) + cosr*(*xx);
+    *yy = sinr*(*xx) + cosr*(*yy);
+    *xx = xxx;
+} // End else
 
 return;
-} // End rpoly
+} // End nextAngle
+
+// Tries shifts first, ..., maxShifts on parallelShifts threads. Each thread takes the next
+// untried shift and runs Fxshfr on its own copy of the K polynomial saved in temp. A
+// shift that converges lowers winner, which cancels the attempts at all later shifts.
+// On return qp holds the deflated polynomial of the converged shift and the shift
+// directions and random generator are where the serial schedule would have left them.
+inline int Akiti::parallelFxshfr(int first, int* NZ, double bnd, double* xx, double* yy, int N, int NN,
+                          double* lzi, double* lzr, double* szi, double* szr) {
+
+int count = strategy.maxShifts - first + 1;
+int threads = ((strategy.parallelShifts < count) ? strategy.parallelShifts : count);
+std::vector<double> xs(count), ys(count);
+std::mt19937 saved(rng);
+std::atomic<int> next(first);
+std::vector<Attempt> attempts(threads);
+std::vector<std::thread> workers;
+
+*NZ = 0;
+if (count <= 0)   return strategy.maxShifts;
+
+// The directions of all remaining shifts, in serial order
+double x = *xx, y = *yy;
+for (int k = 0; k < count; k++){
+    nextAngle(first + k, &x, &y);
+    xs[k] = x;
+    ys[k] = y;
+} // End for k
+
+winner = strategy.maxShifts + 1;
+
+auto work = [&](Attempt& at){
+    for (;;){
+        int jj = next++;
+        if ((jj > strategy.maxShifts) || (jj > winner))   break;
+
+        for (int i = 0; i < N; i++)   at.K[i] = temp[i];
+        shiftCount++;
+        Fxshfr(strategy.firstSteps + strategy.stepGrowth*(jj - 1), &at.NZ, bnd*xs[jj - first], bnd, at.K.data(), N, p, NN,
+               at.qp.data(), &at.lzi, &at.lzr, &at.szi, &at.szr, at.qk.data(), at.svk.data(), jj);
+
+        if (at.NZ != 0){
+            at.shift = jj;
+            int w = winner;
+            while ((jj < w) && !winner.compare_exchange_weak(w, jj)) {}
+            break;
+        } // End if (at.NZ != 0)
+    } // End for
+};
 
-void Akiti::Fxshfr(int L2, int* NZ, double sr, double bnd, double K[], int N, double p[], int NN, double qp[], double* lzi, double* lzr, double* szi, double* szr) {
+for (int t = 0; t < threads; t++){
+    attempts[t].K.resize(mdp1);
+    attempts[t].qp.resize(mdp1);
+    attempts[t].qk.resize(mdp1);
+    attempts[t].svk.resize(mdp1);
+} // End for t
+
+// The calling thread runs an attempt too; if a thread cannot be started the others
+// simply take on more shifts
+for (int t = 1; t < threads; t++){
+    try {
+        workers.push_back(std::thread(work, std::ref(attempts[t])));
+    }
+    catch (...) {
+        break;
+    }
+} // End for t
+work(attempts[0]);
+for (size_t t = 0; t < workers.size(); t++)   workers[t].join();
+
+int jj = winner;
+winner = INT_MAX;
+
+// Leave the random generator and the shift direction as the serial schedule would
+rng = saved;
+int last = ((jj <= strategy.maxShifts) ? jj : strategy.maxShifts);
+for (int k = first; k <= last; k++)   nextAngle(k, xx, yy);
+
+for (int t = 0; t < threads; t++){
+    if ((attempts[t].NZ != 0) && (attempts[t].shift == jj)){
+        *NZ  = attempts[t].NZ;
+        *lzi = attempts[t].lzi;
+        *lzr = attempts[t].lzr;
+        *szi = attempts[t].szi;
+        *szr = attempts[t].szr;
+        for (int i = 0; i < NN; i++)   qp[i] = attempts[t].qp[i];
+        return jj;
+    } // End if
+} // End for t
+
+return strategy.maxShifts;
+} // End parallelFxshfr
+
+inline void Akiti::Fxshfr(int L2, int* NZ, double sr, double bnd, double K[], int N, double p[], int NN, double qp[], double* lzi, double* lzr, double* szi, double* szr, double qk[], double svk[], int shift) {
 
 // Computes up to L2 fixed shift K-polynomials, testing for convergence in the linear or
 // quadratic case. Initiates one of the variable shift iterations and returns with the
@@ -346,11 +658,15 @@ void Akiti::Fxshfr(int L2, int* NZ, double sr, double bnd, double K[], int N, do
 // L2 limit of fixed shift steps
 // NZ number of zeros found
 
-int fflag, i, iFlag, j, spass, stry, tFlag, vpass, vtry;
+int fflag, i, iFlag, j, limit, spass, stall, stry, tFlag, vpass, vtry;
 double a, a1, a3, a7, b, betas, betav, c, d, e, f, g, h, oss, ots, otv, ovv, s, ss, ts, tss, tv, tvv, u, ui, v, vi, vv;
+double need, rate;
 // double qk[MDP1], svk[MDP1];
 
+TraceScope trace(TracePoint::Fxshfr, N);
 *NZ = 0;
+limit = L2;
+stall = 0;
 betav = betas = 0.25;
 u = -(2.0*sr);
 oss = sr;
@@ -361,7 +677,12 @@ QuadSD(NN, u, v, p, qp, &a, &b);
 
 tFlag = calcSC(N, a, b, &a1, &a3, &a7, &c, &d, &e, &f, &g, &h, K, u, v, qk);
 
-for (j = 0; j < L2; j++){
+for (j = 0; j < limit; j++){
+
+    // A speculative attempt stops once an earlier shift has converged
+    if (shift > winner)   break;
+
+    stepCount++;
 
     //Calculate next K polynomial and estimate v
     nextK(N, tFlag, a, b, a1, &a3, &a7, K, qk, qp);
@@ -472,6 +793,31 @@ for (j = 0; j < L2; j++){
 
         } // End if ((spass) || (vpass))
 
+        else if (strategy.adaptive){
+
+            // Abandon the shift if neither sequence has decreased for a while
+
+            stall = (((tv < otv) || (ts < ots)) ? 0 : stall + 1);
+            if (stall >= strategy.stagnationSteps)   break;
+
+            // If the budget runs out while a sequence is still converging, extend it by the
+            // number of steps the observed rate predicts, at most doubling it
+
+            if ((j == limit - 1) && (limit < 2*L2)){
+                need = 0.0;
+                if ((tv < otv) && (tv > 0.0)){
+                    rate = tv/otv;
+                    need = log(betav/tv)/log(rate);
+                } // End if (tv < otv)
+                if ((ts < ots) && (ts > 0.0)){
+                    rate = ts/ots;
+                    need = ((need > 0.0) ? fmin(need, log(betas/ts)/log(rate)) : log(betas/ts)/log(rate));
+                } // End if (ts < ots)
+                if (need > 0.0)   limit = ((limit + need < 2*L2) ? limit + (int)ceil(need) : 2*L2);
+            } // End if ((j == limit - 1) && (limit < 2*L2))
+
+        } // End else if (strategy.adaptive)
+
     } // End if ((j != 0) && (tFlag != 3))
 
     ovv = vv;
@@ -483,25 +829,16 @@ for (j = 0; j < L2; j++){
 return;
 } // End Fxshfr
 
-void Akiti::QuadSD(int NN, double u, double v, double p[], double q[], double* a, double* b) {
+inline void Akiti::QuadSD(int NN, double u, double v, double p[], double q[], double* a, double* b) {
 
 // Divides p by the quadratic 1, u, v placing the quotient in q and the remainder in a, b
 
-int i;
-
-q[0] = *b = p[0];
-q[1] = *a = -((*b)*u) + p[1];
-
-for (i = 2; i < NN; i++){
-    q[i] = -((*a)*u + (*b)*v) + p[i];
-    *b = (*a);
-    *a = q[i];
-} // End for i
+kernels->quadSD(NN, u, v, p, q, a, b);
 
 return;
 } // End QuadSD
 
-int Akiti::calcSC(int N, double a, double b, double* a1, double* a3, double* a7, double* c, double* d,
+inline int Akiti::calcSC(int N, double a, double b, double* a1, double* a3, double* a7, double* c, double* d,
                    double* e, double* f, double* g, double* h, double K[], double u, double v, double qk[]) {
 
 // This routine calculates scalar quantities used to compute the next K polynomial and
@@ -542,7 +879,7 @@ else {
 return dumFlag;
 } // End calcSC
 
-void Akiti::nextK(int N, int tFlag, double a, double b, double a1, double* a3, double* a7,
+inline void Akiti::nextK(int N, int tFlag, double a, double b, double a1, double* a3, double* a7,
                    double K[], double qk[], double qp[]) {
 
 // Computes the next K polynomials using the scalars computed in calcSC
@@ -568,7 +905,7 @@ if (fabs(a1) > (10.0*DBL_EPSILON*fabs(temp))){
     K[0] = qp[0];
     K[1] = -((*a7)*qp[0]) + qp[1];
 
-    for (i = 2; i < N; i++)   K[i] = -((*a7)*qp[i - 1]) + (*a3)*qk[i - 2] + qp[i];
+    kernels->nextK(N, *a7, *a3, qk, qp, true, K);
 
 } // End if (fabs(a1) > (10.0*DBL_EPSILON*fabs(temp)))
 else {
@@ -577,14 +914,14 @@ else {
     K[0] = 0.0;
     K[1] = -(*a7)*qp[0];
 
-    for (i = 2; i < N; i++)   K[i] = -((*a7)*qp[i - 1]) + (*a3)*qk[i - 2];
+    kernels->nextK(N, *a7, *a3, qk, qp, false, K);
 } // End else
 
 return;
 
 } // End nextK
 
-void Akiti::newest(int tFlag, double* uu, double* vv, double a, double a1, double a3, double a7,
+inline void Akiti::newest(int tFlag, double* uu, double* vv, double a, double a1, double a3, double a7,
                     double b, double c, double d, double f, double g, double h, double u, double v,
                     double K[], int N, double p[]) {
 
@@ -624,7 +961,7 @@ if (tFlag != 3){
 return;
 } // End newest
 
-void Akiti::QuadIT(int N, int* NZ, double uu, double vv, double* szr, double* szi, double* lzr, double* lzi,
+inline void Akiti::QuadIT(int N, int* NZ, double uu, double vv, double* szr, double* szi, double* lzr, double* lzi,
                     double qp[], int NN, double* a, double* b, double p[], double qk[], double* a1, double* a3,
                     double* a7, double* d, double* e, double* f, double* g, double* h, double K[]) {
 
@@ -632,8 +969,9 @@ void Akiti::QuadIT(int N, int* NZ, double uu, double vv, double* szr, double* sz
 // zeros are equimodular or nearly so.
 
 int i, j = 0, tFlag, triedFlag = 0;
-double c, ee, mp, omp, relstp, t, u, ui, v, vi, zm;
+double c, ee, mp, omp, r, relstp, orelstp = 0.0, oorelstp = 0.0, sep, t, u, ui, v, vi, zm;
 
+TraceScope trace(TracePoint::QuadIT, N);
 *NZ = 0; // Number of zeros found
 u = uu; // uu and vv are coefficients of the starting quadratic
 v = vv;
@@ -655,11 +993,9 @@ do {
     // Compute a rigorous bound on the rounding error in evaluating p
 
     zm = sqrt(fabs(v));
-    ee = 2.0*fabs(qp[0]);
+    ee = kernels->bound(N, qp, zm, 2.0*fabs(qp[0]));
     t = -((*szr)*(*b));
 
-    for (i = 1; i < N; i++)   ee = ee*zm + fabs(qp[i]);
-
     ee = ee*zm + fabs((*a) + t);
     ee = (9.0*ee + 2.0*fabs(t) - 7.0*(fabs((*a) + t) + zm*fabs((*b))))*DBL_EPSILON;
 
@@ -670,7 +1006,22 @@ do {
         break;
     } // End if (mp <= 20.0*ee)
 
+    // Or if the error left in the zeros is within the requested accuracy. The relative
+    // error left in v is estimated as relstp*r/(1 - r) from the contraction r of its relative
+    // changes, the larger of the last two ratios, as in RealIT. An error dv in v moves the
+    // zeros by about dv/|szr - lzr|: half the relative error for a complex pair, and much
+    // more for two real zeros close together.
+
+    sep = hypot(*szr - *lzr, *szi - *lzi);
+    r = ((j >= 3) && (orelstp > 0.0) && (oorelstp > 0.0) ? fmax(relstp/orelstp, orelstp/oorelstp) : 1.0);
+    if (((atol > 0.0) || (rtol > 0.0)) && (r < 1.0) && (mp < omp) && (sep > 0.0)
+        && (zm*zm*relstp*r/((1.0 - r)*sep) <= atol + rtol*zm)){
+        *NZ = 2;
+        break;
+    } // End if (zm*zm*relstp*r/((1.0 - r)*sep) <= atol + rtol*zm)
+
     j++;
+    iterCount++;
 
     // Stop iteration after 20 steps
     if (j > 20)   break;
@@ -710,6 +1061,8 @@ do {
 
     // If vi is zero, the iteration is not converging
     if (vi != 0){
+        oorelstp = ((j >= 3) ? orelstp : 0.0);
+        orelstp = ((j >= 2) ? relstp : 0.0);
         relstp = fabs((-v + vi)/vi);
         u = ui;
         v = vi;
@@ -720,7 +1073,7 @@ return;
 
 } //End QuadIT
 
-void Akiti::RealIT(int* iFlag, int* NZ, double* sss, int N, double p[], int NN,
+inline void Akiti::RealIT(int* iFlag, int* NZ, double* sss, int N, double p[], int NN,
                     double qp[], double* szr, double* szi, double K[], double qk[]) {
 
 // Variable-shift H-polynomial iteration for a real zero
@@ -730,24 +1083,22 @@ void Akiti::RealIT(int* iFlag, int* NZ, double* sss, int N, double p[], int NN,
 // iFlag - flag to indicate a pair of zeros near real axis
 
 int i, j = 0, nm1 = N - 1;
-double ee, kv, mp, ms, omp, pv, s, t;
+double ee, kv, mp, ms, omp, pv, r, s, t = 0.0, ot = 0.0, oot = 0.0;
 
+TraceScope trace(TracePoint::RealIT, N);
 *iFlag = *NZ = 0;
 s = *sss;
 
 for ( ; ; ) {
-    qp[0] = pv = p[0];
-
     // Evaluate p at s
-    for (i = 1; i < NN; i++)   qp[i] = pv = pv*s + p[i];
+    pv = kernels->horner(NN, p, s, qp);
 
     mp = fabs(pv);
 
     // Compute a rigorous bound on the error in evaluating p
 
     ms = fabs(s);
-    ee = 0.5*fabs(qp[0]);
-    for (i = 1; i < NN; i++)   ee = ee*ms + fabs(qp[i]);
+    ee = kernels->bound(NN, qp, ms, 0.5*fabs(qp[0]));
 
     // Iteration has converged sufficiently if the polynomial value is less than
     // 20 times this bound
@@ -759,7 +1110,21 @@ for ( ; ; ) {
         break;
     } // End if (mp <= 20.0*DBL_EPSILON*(2.0*ee - mp))
 
+    // Or if the error left, estimated as |t|*r/(1 - r) from the contraction r of the steps,
+    // the larger of the last two ratios, is within the requested accuracy. The steps jump
+    // about among the zeros of a cluster, so they must have shrunk twice in a row and the
+    // value of p must still be falling.
+
+    r = ((j >= 3) && (ot != 0.0) && (oot != 0.0) ? fmax(fabs(t/ot), fabs(ot/oot)) : 1.0);
+    if (((atol > 0.0) || (rtol > 0.0)) && (r < 1.0) && (mp < omp) && (fabs(t)*r/(1.0 - r) <= atol + rtol*fabs(s))){
+        *NZ = 1;
+        *szr = s;
+        *szi = 0.0;
+        break;
+    } // End if (fabs(t)*r/(1.0 - r) <= atol + rtol*fabs(s))
+
     j++;
+    iterCount++;
 
     // Stop iteration after 10 steps
 
@@ -782,14 +1147,13 @@ for ( ; ; ) {
     omp = mp;
 
     // Compute t, the next polynomial and the new iterate
-    qk[0] = kv = K[0];
-    for (i = 1; i < N; i++)   qk[i] = kv = kv*s + K[i];
+    kv = kernels->horner(N, K, s, qk);
 
     if (fabs(kv) > fabs(K[nm1])*10.0*DBL_EPSILON){
         // Use the scaled form of the recurrence if the value of K at s is non-zero
         t = -(pv/kv);
         K[0] = qp[0];
-        for (i = 1; i < N; i++)   K[i] = t*qk[i - 1] + qp[i];
+        kernels->realK(N, t, qk, qp, K);
     } // End if (fabs(kv) > fabs(K[nm1])*10.0*DBL_EPSILON)
     else { // else (fabs(kv) <= fabs(K[nm1])*10.0*DBL_EPSILON)
         // Use unscaled form
@@ -797,9 +1161,10 @@ for ( ; ; ) {
         for (i = 1; i < N; i++)   K[i] = qk[i - 1];
     } // End else (fabs(kv) <= fabs(K[nm1])*10.0*DBL_EPSILON)
 
-    kv = K[0];
-    for (i = 1; i < N; i++)   kv = kv*s + K[i];
+    kv = kernels->value(N, K, s);
 
+    oot = ot;
+    ot = t;
     t = ((fabs(kv) > (fabs(K[nm1])*10.0*DBL_EPSILON)) ? -(pv/kv) : 0.0);
 
     s += t;
@@ -810,7 +1175,7 @@ return;
 
 } // End RealIT
 
-void Akiti::Quad(double a, double b1, double c, double* sr, double* si, double* lr, double* li) {
+inline void Akiti::Quad(double a, double b1, double c, double* sr, double* si, double* lr, double* li) {
 // Calculates the zeros of the quadratic a*Z^2 + b1*Z + c
 // The quadratic formula, modified to avoid overflow, is used to find the larger zero if the
 // zeros are real and both zeros are complex. The smaller real zero is found directly from
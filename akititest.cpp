@@ -6,6 +6,10 @@
 #include "helper.h"
 
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <climits>
 #include <stdexcept>
 
 using namespace testing;
@@ -160,3 +164,533 @@ TEST_F(RootFinder, AllRealRootExample) {
          1.0, 1));
 }
 
+
+TEST_F(RootFinder, SquareFreeSplitsMultipleRoots) {
+  Roots rootfinder(rpoly10);
+  rootfinder.setSquareFree(true);
+  // (x-1)^3 (x+2)^2
+  std::vector<double> c = {1, 1, -5, -1, 8, -4};
+  rootfinder.findRoots(c);
+
+  int degree;
+  std::vector<double> zr, zi;
+  std::vector<int> mult;
+  rootfinder.getRoots(degree, zr, zi);
+  rootfinder.getMultiplicities(mult);
+
+  Helper helper;
+  EXPECT_THAT(degree, Eq(5));
+  std::vector<int> sorted(mult);
+  std::sort(sorted.begin(), sorted.end());
+  EXPECT_THAT(sorted, ElementsAre(2, 2, 3, 3, 3));
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMaxPosRealRoot(), 1.0, 10));
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMaxNegRealRoot(), -2.0, 10));
+}
+
+TEST_F(RootFinder, SquareFreeSplitsMultipleComplexRoots) {
+  Roots rootfinder(rpoly10);
+  rootfinder.setSquareFree(true);
+  // (x^2+1)^2 (x-3)
+  std::vector<double> c = {1, -3, 2, -6, 1, -3};
+  rootfinder.findRoots(c);
+
+  int degree;
+  std::vector<double> zr, zi;
+  std::vector<int> mult;
+  rootfinder.getRoots(degree, zr, zi);
+  rootfinder.getMultiplicities(mult);
+
+  Helper helper;
+  std::vector<int> sorted(mult);
+  std::sort(sorted.begin(), sorted.end());
+  EXPECT_THAT(sorted, ElementsAre(1, 2, 2, 2, 2));
+  for(int j=0; j<degree; j++) {
+    if(mult[j] == 2) {
+      EXPECT_THAT(zr[j], DoubleNear(0.0, 1e-14));
+      EXPECT_THAT(std::fabs(zi[j]), DoubleNear(1.0, 1e-14));
+    }
+  }
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMaxPosRealRoot(), 3.0, 10));
+}
+
+TEST_F(RootFinder, SquareFreeLeavesSimpleRootsAlone) {
+  Roots rootfinder(rpoly10);
+  rootfinder.setSquareFree(true);
+  rootfinder.findRoots(coeff);
+
+  std::vector<int> mult;
+  rootfinder.getMultiplicities(mult);
+
+  Helper helper;
+  EXPECT_THAT(mult, Each(Eq(1)));
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMinNegRealRoot(),
+        -6.000000000925208, 100));
+}
+
+TEST_F(RootFinder, StructuralReductionSolvesEvenPolynomialInXSquared) {
+  Roots rootfinder(rpoly10);
+  rootfinder.setStructuralReduction(true);
+  // (x^2-1)(x^2-4)(x^2+9)
+  std::vector<double> c = {1, 0, 4, 0, -41, 0, 36};
+  rootfinder.findRoots(c);
+
+  int nRealRoot;
+  std::vector<double> zr;
+  rootfinder.getRoots(nRealRoot, zr);
+
+  Helper helper;
+  EXPECT_THAT(nRealRoot, Eq(4));
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMaxPosRealRoot(), 2.0, 10));
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMinPosRealRoot(), 1.0, 10));
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMinNegRealRoot(), -1.0, 10));
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMaxNegRealRoot(), -2.0, 10));
+}
+
+TEST_F(RootFinder, StructuralReductionKeepsZerosAtOrigin) {
+  Roots rootfinder(rpoly10);
+  rootfinder.setStructuralReduction(true);
+  // x^2 (x^4 - 16)
+  std::vector<double> c = {1, 0, 0, 0, -16, 0, 0};
+  rootfinder.findRoots(c);
+
+  int degree;
+  std::vector<double> zr, zi;
+  rootfinder.getRoots(degree, zr, zi);
+
+  EXPECT_THAT(zr[0], Eq(0.0));
+  EXPECT_THAT(zr[1], Eq(0.0));
+  for(int j=2; j<degree; j++) {
+    EXPECT_THAT(std::hypot(zr[j], zi[j]), DoubleNear(2.0, 1e-15));
+  }
+  EXPECT_THAT(rootfinder.getMaxPosRealRoot(), Eq(2.0));
+  EXPECT_THAT(rootfinder.getMaxNegRealRoot(), Eq(-2.0));
+}
+
+TEST_F(RootFinder, StructuralReductionLeavesMixedPowersAlone) {
+  // x^5 + x^2 + 1 uses exponents 5 and 2, whose gcd is 1
+  std::vector<double> c = {1, 0, 0, 1, 0, 1};
+  int zeros;
+  Structure structure;
+  EXPECT_THAT(structure.lacunarity(c, zeros), Eq(1));
+  EXPECT_THAT(zeros, Eq(0));
+
+  Roots rootfinder(rpoly10);
+  rootfinder.setStructuralReduction(true);
+  rootfinder.findRoots(c);
+
+  int degree;
+  std::vector<double> zr, zi;
+  rootfinder.getRoots(degree, zr, zi);
+
+  EXPECT_THAT(degree, Eq(5));
+  for(int j=0; j<degree; j++) {
+    std::complex<double> z(zr[j], zi[j]), p(0.0, 0.0);
+    for(double cj : c) p = p*z + cj;
+    EXPECT_THAT(std::abs(p), Lt(1e-12));
+  }
+}
+
+TEST_F(RootFinder, StructuralReductionSolvesBinomial) {
+  // x^4 - 16 = q(x^4) with q(y) = y - 16
+  std::vector<double> c = {1, 0, 0, 0, -16};
+  int zeros;
+  Structure structure;
+  EXPECT_THAT(structure.lacunarity(c, zeros), Eq(4));
+  EXPECT_THAT(zeros, Eq(0));
+
+  Roots rootfinder(rpoly10);
+  rootfinder.setStructuralReduction(true);
+  rootfinder.findRoots(c);
+
+  int degree;
+  std::vector<double> zr, zi;
+  rootfinder.getRoots(degree, zr, zi);
+
+  EXPECT_THAT(degree, Eq(4));
+  for(int j=0; j<degree; j++) {
+    EXPECT_THAT(std::hypot(zr[j], zi[j]), DoubleNear(2.0, 1e-15));
+  }
+  EXPECT_THAT(rootfinder.getMaxPosRealRoot(), Eq(2.0));
+  EXPECT_THAT(rootfinder.getMaxNegRealRoot(), Eq(-2.0));
+}
+
+TEST_F(RootFinder, StructuralReductionSolvesPalindromicPolynomial) {
+  Roots rootfinder(rpoly10);
+  rootfinder.setStructuralReduction(true);
+  // (2x^2-5x+2)(x^2+x+1)(x+1)
+  std::vector<double> c = {2, -1, -4, -4, -1, 2};
+  rootfinder.findRoots(c);
+
+  int degree;
+  std::vector<double> zr, zi;
+  rootfinder.getRoots(degree, zr, zi);
+
+  Helper helper;
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMaxPosRealRoot(), 2.0, 10));
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMinPosRealRoot(), 0.5, 10));
+  EXPECT_THAT(rootfinder.getMinNegRealRoot(), Eq(-1.0));
+  for(int j=0; j<degree; j++) {
+    if(zi[j] != 0.0) {
+      EXPECT_THAT(zr[j], DoubleNear(-0.5, 1e-15));
+      EXPECT_THAT(std::fabs(zi[j]), DoubleNear(std::sqrt(0.75), 1e-15));
+    }
+  }
+}
+
+TEST_F(RootFinder, StructuralReductionSolvesAntiPalindromicPolynomial) {
+  Roots rootfinder(rpoly10);
+  rootfinder.setStructuralReduction(true);
+  // (2x^2-5x+2)(x^2+x+1)(x-1)
+  std::vector<double> c = {2, -5, 2, -2, 5, -2};
+  rootfinder.findRoots(c);
+
+  int nRealRoot;
+  std::vector<double> zr;
+  rootfinder.getRoots(nRealRoot, zr);
+
+  Helper helper;
+  EXPECT_THAT(nRealRoot, Eq(3));
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMaxPosRealRoot(), 2.0, 10));
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMinPosRealRoot(), 0.5, 10));
+}
+
+TEST_F(RootFinder, AdaptiveShiftStrategyFindsSameRoots) {
+  Akiti akiti(10);
+  ShiftStrategy strategy;
+  strategy.adaptive = true;
+  akiti.setShiftStrategy(strategy);
+  Roots rootfinder(&akiti);
+  rootfinder.findRoots(coeff);
+
+  Helper helper;
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMinPosRealRoot(), 0.065297428539350, 100));
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMinNegRealRoot(), -6.000000000925208, 100));
+}
+
+TEST_F(RootFinder, AdaptiveShiftStrategyAbandonsStagnatingShifts) {
+  // A shift of the fixed schedule stagnates on this one and runs out its budget
+  std::vector<double> c = {1, -2, -2, 1, 0, 2, 0, 2, 3, -3, 0, 3, 1, 1, 2, 3, 2, 2, -3, 1};
+
+  ShiftStrategy strategy;
+  Akiti fixed(20), extending(20), adaptive(20);
+  strategy.adaptive = true;
+  adaptive.setShiftStrategy(strategy);
+  // Extensions of the budget alone, without abandoning a shift
+  strategy.stagnationSteps = INT_MAX;
+  extending.setShiftStrategy(strategy);
+
+  Roots one(&fixed), two(&extending), three(&adaptive);
+  one.findRoots(c);
+  two.findRoots(c);
+  three.findRoots(c);
+  EXPECT_THAT(adaptive.getStepCount(), Lt(fixed.getStepCount()));
+  EXPECT_THAT(adaptive.getStepCount(), Lt(extending.getStepCount()));
+
+  int degree;
+  std::vector<double> zr1, zi1, zr3, zi3;
+  one.getRoots(degree, zr1, zi1);
+  three.getRoots(degree, zr3, zi3);
+  std::vector<std::pair<double, double> > z1, z3;
+  for(int j=0; j<degree; j++) {
+    z1.push_back(std::make_pair(zr1[j], zi1[j]));
+    z3.push_back(std::make_pair(zr3[j], zi3[j]));
+  }
+  std::sort(z1.begin(), z1.end());
+  std::sort(z3.begin(), z3.end());
+  for(int j=0; j<degree; j++) {
+    EXPECT_THAT(z3[j].first, DoubleNear(z1[j].first, 1e-8));
+    EXPECT_THAT(z3[j].second, DoubleNear(z1[j].second, 1e-8));
+  }
+}
+
+TEST_F(RootFinder, SolveKeepsRootsFoundBeforeShiftsRunOut) {
+  // A shift of the fixed schedule stagnates on this one, and only one is allowed
+  std::vector<double> c = {1, -2, -2, 1, 0, 2, 0, 2, 3, -3, 0, 3, 1, 1, 2, 3, 2, 2, -3, 1};
+  int N = c.size() - 1;
+  ShiftStrategy strategy;
+  strategy.maxShifts = 1;
+  Akiti hard(N);
+  hard.setShiftStrategy(strategy);
+
+  std::vector<double> op(c), zr(N), zi(N);
+  int found{-1};
+  EXPECT_TRUE(hard.solve(op.data(), N, zr.data(), zi.data(), &found) == RootStatus::NoConvergence);
+  EXPECT_THAT(found, Gt(0));
+  EXPECT_THAT(found, Lt(N));
+
+  // |p(z)| relative to sum |C(j)| |z|^(N-j)
+  auto p = [&c](std::complex<double> z) {
+    std::complex<double> v(0.0, 0.0);
+    double b{0.0};
+    for(double cj : c) {
+      v = v*z + cj;
+      b = b*std::abs(z) + std::fabs(cj);
+    }
+    return std::abs(v)/b;
+  };
+  for(int j=0; j<found; j++) {
+    EXPECT_THAT(p(std::complex<double>(zr[j], zi[j])), Lt(1e-8));
+  }
+
+  // The remainder holds exactly the roots not found
+  Roots rootfinder(&hard);
+  int n;
+  EXPECT_TRUE(rootfinder.solve(c, n) == RootStatus::NoConvergence);
+  EXPECT_THAT(n, Eq(found));
+  std::vector<double> rem;
+  rootfinder.getRemainder(rem);
+  ASSERT_THAT((int)rem.size() - 1, Eq(N - found));
+
+  Akiti akiti(N);
+  Roots other(&akiti);
+  other.findRoots(rem);
+  std::vector<double> wr, wi;
+  other.getFoundRoots(wr, wi);
+  ASSERT_THAT((int)wr.size(), Eq(N - found));
+  for(int j=0; j<N-found; j++) {
+    EXPECT_THAT(p(std::complex<double>(wr[j], wi[j])), Lt(1e-8));
+  }
+}
+
+TEST_F(RootFinder, ShiftAndStepCountsAreReported) {
+  Akiti akiti(10);
+  Roots rootfinder(&akiti);
+  rootfinder.findRoots(coeff);
+
+  EXPECT_THAT(akiti.getShiftCount(), Ge(1));
+  EXPECT_THAT(akiti.getStepCount(), Ge(akiti.getShiftCount()));
+}
+
+TEST_F(RootFinder, RandomRestartsAreReproducibleForASeed) {
+  ShiftStrategy strategy;
+  strategy.randomRestarts = true;
+  strategy.seed = 42;
+  Akiti first(10), second(10);
+  first.setShiftStrategy(strategy);
+  second.setShiftStrategy(strategy);
+
+  Roots one(&first), two(&second);
+  one.findRoots(coeff);
+  two.findRoots(coeff);
+
+  int degree;
+  std::vector<double> zr1, zi1, zr2, zi2;
+  one.getRoots(degree, zr1, zi1);
+  two.getRoots(degree, zr2, zi2);
+  zr1.resize(degree);
+  zi1.resize(degree);
+  zr2.resize(degree);
+  zi2.resize(degree);
+  EXPECT_THAT(zr1, Eq(zr2));
+  EXPECT_THAT(zi1, Eq(zi2));
+  EXPECT_THAT(first.getStepCount(), Eq(second.getStepCount()));
+}
+
+TEST_F(RootFinder, RandomRestartsDoNotDependOnEarlierSolves) {
+  std::vector<double> c(41);
+  for(int j=0; j<=40; j++) c[j] = (double)((j*7) % 11) - 5.0;
+  c[0] = 1.0;
+
+  // Short shifts make many fail, so that the random angles are drawn
+  ShiftStrategy strategy;
+  strategy.firstSteps = 1;
+  strategy.stepGrowth = 1;
+  strategy.randomRestarts = true;
+  Akiti used(40), fresh(40);
+  used.setShiftStrategy(strategy);
+  fresh.setShiftStrategy(strategy);
+
+  Roots one(&used), two(&fresh);
+  one.findRoots(coeff);
+  one.findRoots(c);
+  two.findRoots(c);
+
+  int degree;
+  std::vector<double> zr1, zi1, zr2, zi2;
+  one.getRoots(degree, zr1, zi1);
+  two.getRoots(degree, zr2, zi2);
+  zr1.resize(degree);
+  zi1.resize(degree);
+  zr2.resize(degree);
+  zi2.resize(degree);
+  EXPECT_THAT(used.getShiftCount(), Gt(degree/2));
+  EXPECT_THAT(zr1, Eq(zr2));
+  EXPECT_THAT(zi1, Eq(zi2));
+  EXPECT_THAT(used.getStepCount(), Eq(fresh.getStepCount()));
+}
+
+TEST_F(RootFinder, AccuracyTargetStopsIterationsEarly) {
+  std::vector<double> c = {1, 1, 1, -2, 0, 1, 2, -2, -1, 1, 1, 0, 1, -3, 1, 2, -3, 1, 3, -2, 1, -3, -3, 3, -2, 2,
+                           -2, 1, 2, 1, 0, -1, -2, 2, -3, -2, -2, 2, 1, 3, -2, -3, -1, -2};
+
+  Akiti full(50), loose(50);
+  Roots exact(&full), rough(&loose);
+  exact.findRoots(c);
+  rough.findRoots(c, 1.0e-6, 0.0);
+  EXPECT_THAT(loose.getIterationCount(), Lt(full.getIterationCount()));
+
+  // Each rough root within the target of a full precision one
+  int degree;
+  std::vector<double> zr1, zi1, zr2, zi2;
+  exact.getRoots(degree, zr1, zi1);
+  rough.getRoots(degree, zr2, zi2);
+  for(int j=0; j<degree; j++) {
+    double nearest = HUGE_VAL;
+    for(int k=0; k<degree; k++) nearest = std::min(nearest, std::hypot(zr2[j] - zr1[k], zi2[j] - zi1[k]));
+    EXPECT_THAT(nearest, Le(1.0e-6*std::hypot(zr2[j], zi2[j])));
+  }
+}
+
+TEST_F(RootFinder, ParallelShiftsFindTheRootsOfTheSerialSchedule) {
+  std::vector<double> c(41);
+  for(int j=0; j<=40; j++) c[j] = (double)((j*7) % 11) - 5.0;
+  c[0] = 1.0;
+
+  // Short shifts make the first shift fail for many zeros
+  ShiftStrategy strategy;
+  strategy.firstSteps = 1;
+  strategy.stepGrowth = 1;
+  Akiti serial(40), parallel(40);
+  serial.setShiftStrategy(strategy);
+  strategy.parallelShifts = 4;
+  parallel.setShiftStrategy(strategy);
+
+  Roots one(&serial), two(&parallel);
+  one.findRoots(c);
+  two.findRoots(c);
+
+  int degree;
+  std::vector<double> zr1, zi1, zr2, zi2;
+  one.getRoots(degree, zr1, zi1);
+  two.getRoots(degree, zr2, zi2);
+  zr1.resize(degree);
+  zi1.resize(degree);
+  zr2.resize(degree);
+  zi2.resize(degree);
+  EXPECT_THAT(serial.getShiftCount(), Gt(degree/2));
+  EXPECT_THAT(zr1, Eq(zr2));
+  EXPECT_THAT(zi1, Eq(zi2));
+}
+
+TEST_F(RootFinder, ModuliRadiusTakesFewerShiftSteps) {
+  // Graded coefficients, with roots spread over several orders of magnitude
+  std::vector<double> c(41);
+  for(int j=0; j<=40; j++) c[j] = pow(10.0, -0.02*j*j + (j % 3));
+
+  ShiftStrategy strategy;
+  Akiti cauchy(40), moduli(40);
+  strategy.moduliRadius = true;
+  moduli.setShiftStrategy(strategy);
+
+  Roots one(&cauchy), two(&moduli);
+  one.findRoots(c);
+  two.findRoots(c);
+  EXPECT_THAT(moduli.getStepCount(), Lt(cauchy.getStepCount()));
+
+  int degree;
+  std::vector<double> zr1, zi1, zr2, zi2;
+  one.getRoots(degree, zr1, zi1);
+  two.getRoots(degree, zr2, zi2);
+  std::vector<std::pair<double, double> > z1, z2;
+  for(int j=0; j<degree; j++) {
+    z1.push_back(std::make_pair(zr1[j], zi1[j]));
+    z2.push_back(std::make_pair(zr2[j], zi2[j]));
+  }
+  std::sort(z1.begin(), z1.end());
+  std::sort(z2.begin(), z2.end());
+  for(int j=0; j<degree; j++) {
+    double scale = std::hypot(z1[j].first, z1[j].second);
+    EXPECT_THAT(z2[j].first, DoubleNear(z1[j].first, 1e-8*scale));
+    EXPECT_THAT(z2[j].second, DoubleNear(z1[j].second, 1e-8*scale));
+  }
+}
+
+TEST_F(RootFinder, LazyRootsComeInIncreasingModulus) {
+  int degree = 60;
+  std::vector<double> c(degree + 1);
+  for(int j=0; j<=degree; j++) c[j] = ((j*7) % 11) - 5;
+  c[0] = 1.0;
+
+  Akiti full(degree), lazy(degree);
+  Roots all(&full), few(&lazy);
+  all.findRoots(c);
+  int nRoots;
+  std::vector<double> zr, zi, modulus;
+  all.getRoots(nRoots, zr, zi);
+  for(int j=0; j<degree; j++) modulus.push_back(std::hypot(zr[j], zi[j]));
+  std::sort(modulus.begin(), modulus.end());
+
+  // The three smallest, then the deflation stops
+  few.beginRoots(c);
+  double last = 0.0;
+  for(int j=0; j<3; j++) {
+    double x, y;
+    ASSERT_TRUE(few.nextRoot(x, y));
+    EXPECT_THAT(std::hypot(x, y), DoubleNear(modulus[j], 1e-10));
+    EXPECT_THAT(std::hypot(x, y), Ge(last));
+    last = std::hypot(x, y);
+  }
+  EXPECT_THAT(lazy.getStepCount(), Lt(full.getStepCount()/4));
+}
+
+TEST_F(RootFinder, LazyRootsRunOutAfterDegree) {
+  Roots rootfinder(rpoly10);
+  // (x-3)(x+1)(x^2+4)
+  std::vector<double> c = {1, -2, 1, -8, -12};
+  rootfinder.beginRoots(c);
+  double x, y;
+  std::vector<double> modulus;
+  while(rootfinder.nextRoot(x, y)) modulus.push_back(std::hypot(x, y));
+  EXPECT_THAT(modulus, ElementsAre(DoubleNear(1.0, 1e-12), DoubleNear(2.0, 1e-12),
+                                   DoubleNear(2.0, 1e-12), DoubleNear(3.0, 1e-12)));
+}
+
+TEST_F(RootFinder, RationalRootsOfAllRealRootExampleAreExact) {
+  Roots rootfinder(rpoly10);
+  rootfinder.setRationalRoots(true);
+  // (x-1)(x-2)...(x-10)
+  std::vector<double> c = {1, -55, 1320, -18150, 157773, -902055, 3416930, -8409500, 12753576,
+                           -10628640, 3628800};
+  rootfinder.findRoots(c);
+
+  int nRealRoot;
+  std::vector<double> zr;
+  rootfinder.getRoots(nRealRoot, zr);
+  zr.resize(nRealRoot);
+  std::sort(zr.begin(), zr.end());
+  ASSERT_THAT(nRealRoot, Eq(10));
+  for(int j=0; j<10; j++) {
+    EXPECT_THAT(zr[j], Eq(j + 1.0));
+  }
+}
+
+TEST_F(RootFinder, RationalRootsLeaveTheOtherFactorToTheSolver) {
+  Roots rootfinder(rpoly10);
+  rootfinder.setRationalRoots(true);
+  // (2x-3)^2 x (x^2-2), the irrational roots from the solve
+  std::vector<double> c = {4, -12, 1, 24, -18, 0};
+  rootfinder.findRoots(c);
+
+  int degree;
+  std::vector<double> zr, zi;
+  std::vector<int> mult;
+  rootfinder.getRoots(degree, zr, zi);
+  rootfinder.getMultiplicities(mult);
+  ASSERT_THAT(degree, Eq(5));
+  EXPECT_THAT(zr[0], Eq(0.0));
+  EXPECT_THAT(zr[1], Eq(1.5));
+  EXPECT_THAT(zr[2], Eq(1.5));
+  EXPECT_THAT(mult, ElementsAre(1, 2, 2, 1, 1));
+  EXPECT_THAT(std::fabs(zr[3]), DoubleNear(std::sqrt(2.0), 1e-15));
+  EXPECT_THAT(zr[3] + zr[4], DoubleNear(0.0, 1e-15));
+}
+
+TEST_F(RootFinder, RationalRootsSkipNonIntegralCoefficients) {
+  Roots rootfinder(rpoly10);
+  rootfinder.setRationalRoots(true);
+  rootfinder.findRoots(coeff);
+
+  Helper helper;
+  EXPECT_TRUE(helper.nearly_equal(rootfinder.getMinNegRealRoot(),
+        -6.000000000925208, 100));
+}
@@ -0,0 +1,198 @@
+#include "akiti.h"
+#include "roots.h"
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define ROOTS_COROUTINES 1
+#endif
+#endif
+
+#ifndef AsyncRoots_h
+#define AsyncRoots_h
+
+// Asynchronous front end of Roots: submit hands a polynomial to a pool of workers and
+// returns at once, with a std::future of its roots, or, from C++20 coroutines, with an
+// awaitable that resumes the coroutine once they are there.
+//
+// Each worker has its own Akiti and Roots, for polynomials of degree up to maxDegree, and
+// solves with the exception-free Roots::solve, so that a failure to converge comes back
+// in the status of the result instead of as an exception. A worker takes up to maxBatch
+// waiting polynomials off the queue at a time, so that under load the cost of the lock and
+// of waking a thread is paid once per batch rather than once per polynomial; submitting
+// several polynomials at once queues them under one lock as well. It takes no more than
+// its share of the queue among the workers, at least one, so that a burst is spread over
+// them instead of going to the first one awake.
+//
+// The destructor solves what is still queued before it joins the workers. A coroutine
+// awaiting a result is resumed on the worker that solved it.
+
+class AsyncRoots {
+  public:
+    AsyncRoots(int maxDegree, int threads = 0, int maxBatch = 32);
+    ~AsyncRoots(void);
+    std::future<RootResult> submit(const std::vector<double>& coeff, double rtol = 0.0, double atol = 0.0);
+    std::vector<std::future<RootResult> > submit(const std::vector<std::vector<double> >& coeffs,
+                                                 double rtol = 0.0, double atol = 0.0);
+    void submit(const std::vector<double>& coeff, std::function<void(RootResult&)> done,
+                double rtol = 0.0, double atol = 0.0);
+    int getThreads(void) const;
+
+#ifdef ROOTS_COROUTINES
+    class Awaitable;
+    Awaitable solve(const std::vector<double>& coeff, double rtol = 0.0, double atol = 0.0);
+#endif
+
+  private:
+    struct Request {
+      std::vector<double> coeff;
+      double rtol;
+      double atol;
+      std::function<void(RootResult&)> done;
+    };
+
+    int maxDegree;
+    int maxBatch;
+    int threads;
+    std::vector<std::thread> workers;
+    std::deque<Request> queue;
+    std::mutex lock;
+    std::condition_variable waiting;
+    bool stopping{false};
+
+    void check(const std::vector<double>& coeff) const;
+    void work(void);
+};
+
+#ifdef ROOTS_COROUTINES
+class AsyncRoots::Awaitable {
+  public:
+    bool await_ready(void) const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) {
+      pool->submit(coeff, [this, h](RootResult& r) {
+        result = std::move(r);
+        h.resume();
+      }, rtol, atol);
+    }
+    RootResult await_resume(void) { return std::move(result); }
+
+  private:
+    friend class AsyncRoots;
+    Awaitable(AsyncRoots* pool, const std::vector<double>& coeff, double rtol, double atol)
+      : pool(pool), coeff(coeff), rtol(rtol), atol(atol) {}
+
+    AsyncRoots* pool;
+    std::vector<double> coeff;
+    double rtol;
+    double atol;
+    RootResult result;
+};
+
+inline AsyncRoots::Awaitable AsyncRoots::solve(const std::vector<double>& coeff, double rtol, double atol) {
+  check(coeff);
+  return Awaitable(this, coeff, rtol, atol);
+}
+#endif
+
+inline AsyncRoots::AsyncRoots(int maxDegree, int threads, int maxBatch)
+  : maxDegree(maxDegree), maxBatch(maxBatch), threads(threads) {
+  if(threads <= 0)   threads = std::thread::hardware_concurrency();
+  if(threads <= 0)   threads = 1;
+  if(this->maxBatch < 1)   this->maxBatch = 1;
+  this->threads = threads;
+  for(int t=0; t<threads; t++) workers.push_back(std::thread(&AsyncRoots::work, this));
+}
+
+inline AsyncRoots::~AsyncRoots(void) {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stopping = true;
+  }
+  waiting.notify_all();
+  for(size_t t=0; t<workers.size(); t++) workers[t].join();
+}
+
+inline int AsyncRoots::getThreads(void) const {
+  return workers.size();
+}
+
+inline void AsyncRoots::check(const std::vector<double>& coeff) const {
+  if(coeff.size() < 2) {
+    throw std::invalid_argument( "A polynomial needs at least two coefficients." );
+  }
+}
+
+inline void AsyncRoots::submit(const std::vector<double>& coeff, std::function<void(RootResult&)> done,
+                               double rtol, double atol) {
+  check(coeff);
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    queue.push_back(Request{coeff, rtol, atol, done});
+  }
+  waiting.notify_one();
+}
+
+inline std::future<RootResult> AsyncRoots::submit(const std::vector<double>& coeff, double rtol, double atol) {
+  std::shared_ptr<std::promise<RootResult> > promise = std::make_shared<std::promise<RootResult> >();
+  std::future<RootResult> result = promise->get_future();
+  submit(coeff, [promise](RootResult& r) { promise->set_value(std::move(r)); }, rtol, atol);
+  return result;
+}
+
+inline std::vector<std::future<RootResult> > AsyncRoots::submit(const std::vector<std::vector<double> >& coeffs,
+                                                                double rtol, double atol) {
+  for(size_t j=0; j<coeffs.size(); j++) check(coeffs[j]);
+  std::vector<std::future<RootResult> > results;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    for(size_t j=0; j<coeffs.size(); j++) {
+      std::shared_ptr<std::promise<RootResult> > promise = std::make_shared<std::promise<RootResult> >();
+      results.push_back(promise->get_future());
+      queue.push_back(Request{coeffs[j], rtol, atol, [promise](RootResult& r) { promise->set_value(std::move(r)); }});
+    }
+  }
+  waiting.notify_all();
+  return results;
+}
+
+inline void AsyncRoots::work(void) {
+  Akiti akiti(maxDegree);
+  Roots roots(&akiti);
+  std::vector<Request> batch;
+
+  for(;;) {
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      waiting.wait(guard, [this]() { return stopping || !queue.empty(); });
+      if(queue.empty()) return;
+      size_t share = std::max<size_t>(1, std::min<size_t>(maxBatch, queue.size()/threads));
+      while(batch.size() < share) {
+        batch.push_back(std::move(queue.front()));
+        queue.pop_front();
+      }
+    }
+    // Leave the rest of the queue to the other workers
+    waiting.notify_one();
+
+    for(size_t j=0; j<batch.size(); j++) {
+      RootResult r;
+      r.status = roots.solve(batch[j].coeff, r.found, batch[j].rtol, batch[j].atol);
+      roots.getFoundRoots(r.zr, r.zi);
+      batch[j].done(r);
+    }
+    batch.clear();
+  }
+}
+
+#endif
@@ -0,0 +1,143 @@
+#include "gmock/gmock.h"
+
+#include "async.h"
+#include "akiti.h"
+#include "roots.h"
+
+#include <vector>
+#include <thread>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include <chrono>
+#include <stdexcept>
+
+using namespace testing;
+
+class Async: public Test {
+  public:
+    // (x - 1)(x - 2)(x - 3)(x^2 + 1)
+    std::vector<double> coeff = {1.0, -6.0, 12.0, -12.0, 11.0, -6.0};
+
+    // (x - k)(x + 2k)(x - 3k)
+    std::vector<double> cubic(double k) {
+      return {1.0, 0.0, -7.0*k*k, 6.0*k*k*k};
+    }
+};
+
+TEST_F(Async, FutureHoldsTheRootsOfRoots) {
+  AsyncRoots pool(10, 2);
+  std::future<RootResult> f = pool.submit(coeff);
+
+  Akiti akiti(10);
+  Roots rootfinder(&akiti);
+  int degree;
+  std::vector<double> zr, zi;
+  rootfinder.findRoots(coeff);
+  rootfinder.getRoots(degree, zr, zi);
+
+  RootResult r = f.get();
+  ASSERT_THAT(r.status, Eq(RootStatus::Success));
+  ASSERT_THAT(r.found, Eq(5));
+  for(int j=0; j<5; j++) {
+    ASSERT_THAT(r.zr[j], Eq(zr[j]));
+    ASSERT_THAT(r.zi[j], Eq(zi[j]));
+  }
+}
+
+TEST_F(Async, PolynomialOfMaximalDegree) {
+  AsyncRoots pool(5, 1);
+  RootResult r = pool.submit(coeff).get();
+  ASSERT_THAT(r.status, Eq(RootStatus::Success));
+  ASSERT_THAT(r.found, Eq(5));
+  ASSERT_THAT(r.zr.size(), Eq(5u));
+  ASSERT_THAT(r.zi.size(), Eq(5u));
+}
+
+TEST_F(Async, ConcurrentClientsGetTheirOwnRoots) {
+  AsyncRoots pool(10, 3, 4);
+  std::vector<std::thread> clients;
+  std::vector<int> wrong(6, 0);
+  for(int c=0; c<6; c++) {
+    clients.push_back(std::thread([&, c]() {
+      std::vector<std::vector<double> > polys;
+      for(int j=1; j<=20; j++) polys.push_back(cubic(c*20 + j));
+      std::vector<std::future<RootResult> > results = pool.submit(polys);
+      for(int j=1; j<=20; j++) {
+        RootResult r = results[j - 1].get();
+        double k = c*20 + j, sum{0.0};
+        for(int i=0; i<r.found; i++) sum += std::fabs(r.zr[i]);
+        // |k| + |-2k| + |3k|
+        if(r.found != 3 || std::fabs(sum - 6.0*k) > 1.0e-9*k) wrong[c]++;
+      }
+    }));
+  }
+  for(size_t c=0; c<clients.size(); c++) clients[c].join();
+  ASSERT_THAT(wrong, Each(Eq(0)));
+}
+
+TEST_F(Async, FailuresComeBackInTheStatus) {
+  AsyncRoots pool(4, 1);
+  std::vector<double> zero = {0.0, 1.0, 2.0};
+  ASSERT_THAT(pool.submit(zero).get().status, Eq(RootStatus::LeadingCoefficientZero));
+  RootResult r = pool.submit(coeff).get();
+  ASSERT_THAT(r.status, Eq(RootStatus::DegreeTooLarge));
+  ASSERT_THAT(r.found, Eq(0));
+  ASSERT_THROW(pool.submit(std::vector<double>(1, 1.0)), std::invalid_argument);
+}
+
+TEST_F(Async, DestructorSolvesWhatIsQueued) {
+  std::vector<std::future<RootResult> > results;
+  {
+    AsyncRoots pool(10, 1, 8);
+    for(int j=0; j<100; j++) results.push_back(pool.submit(cubic(j + 1)));
+  }
+  for(size_t j=0; j<results.size(); j++) {
+    ASSERT_THAT(results[j].wait_for(std::chrono::seconds(0)), Eq(std::future_status::ready));
+    ASSERT_THAT(results[j].get().found, Eq(3));
+  }
+}
+
+TEST_F(Async, BurstIsSpreadOverTheWorkers) {
+  // The burst is queued while every worker is held in a callback; then each callback of the
+  // burst holds its worker until another worker has solved one, which it only can if the
+  // first worker to take from the queue left it some of the burst
+  int threads{4};
+  AsyncRoots pool(10, threads, 32);
+  std::mutex lock;
+  std::condition_variable seen;
+  int held{0};
+  bool release{false};
+  std::set<std::thread::id> workers;
+  int done{0};
+  for(int j=0; j<threads; j++) {
+    // One at a time, so that each goes to a worker not yet held
+    pool.submit(cubic(j + 1), [&](RootResult&) {
+      std::unique_lock<std::mutex> guard(lock);
+      held++;
+      seen.notify_all();
+      seen.wait_for(guard, std::chrono::seconds(10), [&]() { return release; });
+    });
+    std::unique_lock<std::mutex> guard(lock);
+    seen.wait_for(guard, std::chrono::seconds(10), [&]() { return held == j + 1; });
+  }
+  for(int j=0; j<threads; j++) {
+    pool.submit(cubic(j + 1), [&](RootResult&) {
+      std::unique_lock<std::mutex> guard(lock);
+      workers.insert(std::this_thread::get_id());
+      seen.notify_all();
+      seen.wait_for(guard, std::chrono::seconds(10), [&]() { return workers.size() > 1; });
+      done++;
+      seen.notify_all();
+    });
+  }
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    release = true;
+  }
+  seen.notify_all();
+  std::unique_lock<std::mutex> guard(lock);
+  seen.wait(guard, [&]() { return done == threads; });
+  ASSERT_THAT(workers.size(), Gt((size_t)1));
+}
@@ -0,0 +1,231 @@
+#include "akiti.h"
+#include "topology.h"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <limits>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifndef BatchSolver_h
+#define BatchSolver_h
+
+// Many polynomials of one degree N, solved in place in caller-owned buffers and spread
+// over threads.
+//
+// Polynomial b has its N+1 coefficients, leading one first, at c + b*cstride; its roots go
+// to zr + b*zstride and zi + b*zstride and the number found to found[b]. The strides count
+// doubles, so the rows of a C-ordered matrix, and of a larger one, are read and written
+// without a copy. A polynomial that is not solved completely, for a leading coefficient of
+// zero or a failure to converge, keeps the roots found so far and NaN in the other places.
+//
+// Each thread has its own Akiti, kept between calls as the workspace of the solver, and
+// takes the next block of polynomials when done with one, so that polynomials that take
+// long do not hold up the others. threads = 0 uses one per hardware thread. setAccuracy
+// sets the accuracy target of RPoly on every workspace.
+//
+// Given a NumaTopology, there is one thread per CPU of it, pinned to that CPU, and the
+// rows are split between the nodes in proportion to their CPUs. The threads of a node take
+// blocks from the rows of their node, and from those of the other nodes only once theirs
+// are done. Each thread allocates its own workspace, so that it is placed on its node, and
+// allocate gives arrays for coefficients and roots whose rows are first touched by the
+// threads of the node that will solve them; a batch in such arrays is read and written
+// almost only from local memory. Without a topology the machine counts as one node and no
+// thread is pinned.
+
+class BatchSolver {
+  public:
+    BatchSolver(int maxDegree, int threads = 0);
+    BatchSolver(int maxDegree, const NumaTopology& topology);
+    ~BatchSolver(void);
+    int solve(int count, int N, const double* c, std::ptrdiff_t cstride, double* zr, double* zi,
+              std::ptrdiff_t zstride, int* found);
+    double* allocate(int count, std::ptrdiff_t stride);
+    void release(double* buffer);
+    int getThreads(void) const;
+    int getNode(int count, int b) const;
+    int getRemoteBlocks(void) const;
+    void setAccuracy(double rtol, double atol);
+
+  private:
+    int maxDegree;
+    int threads;
+    NumaTopology topology;
+    std::vector<Akiti*> workspace;
+    // Node and CPU of each thread
+    std::vector<int> node;
+    std::vector<int> cpu;
+    std::atomic<int> remote{0};
+
+    // Polynomials handed to a thread at a time
+    static const int Block = 16;
+
+    void start(void);
+    void first(int count, std::vector<int>& start) const;
+    template<class Body> void parallel(Body body);
+};
+
+inline BatchSolver::BatchSolver(int maxDegree, int threads)
+  : maxDegree(maxDegree), topology(NumaTopology::single(threads)) {
+  start();
+}
+
+inline BatchSolver::BatchSolver(int maxDegree, const NumaTopology& topology)
+  : maxDegree(maxDegree), topology(topology) {
+  start();
+}
+
+inline void BatchSolver::start(void) {
+  threads = topology.getThreads();
+  for(int k=0; k<topology.getNodes(); k++) {
+    for(size_t j=0; j<topology.getCpus(k).size(); j++) {
+      node.push_back(k);
+      cpu.push_back(topology.getCpus(k)[j]);
+    }
+  }
+  workspace.assign(threads, nullptr);
+  if(!topology.isPinned()) {
+    for(int t=0; t<threads; t++) workspace[t] = new Akiti(maxDegree);
+    return;
+  }
+  // Each on its own node; a thread that fails leaves its workspace to be made here
+  parallel([this](int t) { workspace[t] = new (std::nothrow) Akiti(maxDegree); });
+  for(int t=0; t<threads; t++) {
+    if(workspace[t] == nullptr)   workspace[t] = new Akiti(maxDegree);
+  }
+}
+
+inline BatchSolver::~BatchSolver(void) {
+  for(size_t t=0; t<workspace.size(); t++) delete workspace[t];
+}
+
+inline int BatchSolver::getThreads(void) const {
+  return threads;
+}
+
+inline void BatchSolver::setAccuracy(double rtol, double atol) {
+  for(size_t t=0; t<workspace.size(); t++) {
+    workspace[t]->rtol = rtol;
+    workspace[t]->atol = atol;
+  }
+}
+
+// Blocks taken by threads from the rows of another node in the last solve
+inline int BatchSolver::getRemoteBlocks(void) const {
+  return remote;
+}
+
+// Runs body(t) for every thread t; pinned threads all run apart from the caller, whose
+// affinity is left alone
+template<class Body> inline void BatchSolver::parallel(Body body) {
+  bool pinned = topology.isPinned();
+  std::vector<std::thread> workers;
+  for(int t=(pinned ? 0 : 1); t<threads; t++) {
+    workers.push_back(std::thread([this, t, pinned, &body]() {
+      if(pinned)   topology.pin(cpu[t]);
+      body(t);
+    }));
+  }
+  if(!pinned)   body(0);
+  for(size_t t=0; t<workers.size(); t++) workers[t].join();
+}
+
+// The first row of each node, and count after the last
+inline void BatchSolver::first(int count, std::vector<int>& start) const {
+  int K = topology.getNodes();
+  start.assign(K + 1, count);
+  long long cpus{0};
+  for(int k=0; k<K; k++) {
+    start[k] = (int)(count*cpus/threads);
+    cpus += topology.getCpus(k).size();
+  }
+}
+
+// The node whose threads solve row b of a batch of count rows
+inline int BatchSolver::getNode(int count, int b) const {
+  std::vector<int> start;
+  first(count, start);
+  int k{0};
+  while(k + 1 < topology.getNodes() && b >= start[k + 1]) k++;
+  return k;
+}
+
+// count rows of stride doubles, each first touched by a thread of the node that solves
+// it; free with release
+inline double* BatchSolver::allocate(int count, std::ptrdiff_t stride) {
+  size_t bytes = std::max<size_t>(1, (size_t)count*stride*sizeof(double));
+  void* buffer{nullptr};
+  if(posix_memalign(&buffer, 4096, bytes) != 0) throw std::bad_alloc();
+  double* x = (double*)buffer;
+
+  std::vector<int> start;
+  first(count, start);
+  std::vector<int> rank(threads), size(topology.getNodes(), 0);
+  for(int t=0; t<threads; t++) rank[t] = size[node[t]]++;
+  parallel([&](int t) {
+    // The rows of the node, split between its threads
+    int k = node[t], a = start[k], n = start[k + 1] - a;
+    int lo = a + (int)((long long)n*rank[t]/size[k]), hi = a + (int)((long long)n*(rank[t] + 1)/size[k]);
+    for(std::ptrdiff_t j=lo*stride; j<hi*stride; j++) x[j] = 0.0;
+  });
+  return x;
+}
+
+inline void BatchSolver::release(double* buffer) {
+  free(buffer);
+}
+
+// Returns the number of polynomials not solved completely
+inline int BatchSolver::solve(int count, int N, const double* c, std::ptrdiff_t cstride, double* zr, double* zi,
+                              std::ptrdiff_t zstride, int* found) {
+  int K = topology.getNodes();
+  std::vector<int> start;
+  first(count, start);
+  std::vector<std::atomic<int> > next(K);
+  for(int k=0; k<K; k++) next[k] = start[k];
+  std::atomic<int> failed{0};
+  remote = 0;
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  auto body = [&](int t) {
+    Akiti* akiti = workspace[t];
+    // The rows of the own node first, then those of the others in turn
+    for(int j=0; j<K; j++) {
+      int k = (node[t] + j) % K;
+      for(int first=next[k].fetch_add(Block); first<start[k + 1]; first=next[k].fetch_add(Block)) {
+        if(j > 0)   remote++;
+        for(int b=first; b<first+Block && b<start[k + 1]; b++) {
+          double* r = zr + b*zstride;
+          double* i = zi + b*zstride;
+          int n{0};
+          RootStatus status = RootStatus::DegreeTooLarge;
+          if(N <= maxDegree) {
+            // solve only reads the coefficients
+            status = akiti->solve(const_cast<double*>(c + b*cstride), N, r, i, &n);
+          }
+          for(int l=n; l<N; l++) r[l] = i[l] = nan;
+          if(found != nullptr)   found[b] = n;
+          if(status != RootStatus::Success)   failed++;
+        }
+      }
+    }
+  };
+
+  if(topology.isPinned()) {
+    parallel(body);
+  }
+  else {
+    // No more threads than blocks
+    int T = std::min(threads, (count + Block - 1)/Block);
+    std::vector<std::thread> workers;
+    for(int t=1; t<T; t++) workers.push_back(std::thread(body, t));
+    body(0);
+    for(size_t t=0; t<workers.size(); t++) workers[t].join();
+  }
+  return failed;
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include "gmock/gmock.h"
+
+#include "batch.h"
+#include "topology.h"
+
+#include <vector>
+#include <random>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+
+using namespace testing;
+
+class Batch: public Test {
+  public:
+    int count{200};
+    int N{12};
+
+    void fill(double* c) {
+      std::mt19937 rng(5);
+      std::uniform_real_distribution<double> u(-1.0, 1.0);
+      for(int j=0; j<count*(N + 1); j++) c[j] = u(rng);
+    }
+};
+
+TEST_F(Batch, DetectedTopologyHasCpus) {
+  NumaTopology topology = NumaTopology::detect();
+  ASSERT_THAT(topology.getNodes(), Ge(1));
+  ASSERT_THAT(topology.getThreads(), Ge(1));
+  ASSERT_THROW(NumaTopology::simulated(0, 4), std::invalid_argument);
+}
+
+TEST_F(Batch, SimulatedNodesShareTheRowsByTheirCpus) {
+  NumaTopology topology = NumaTopology::simulated(2, 2);
+  BatchSolver batch(N, topology);
+  ASSERT_THAT(batch.getThreads(), Eq(4));
+  ASSERT_THAT(batch.getNode(count, 0), Eq(0));
+  ASSERT_THAT(batch.getNode(count, 99), Eq(0));
+  ASSERT_THAT(batch.getNode(count, 100), Eq(1));
+  ASSERT_THAT(batch.getNode(count, 199), Eq(1));
+}
+
+TEST_F(Batch, PinnedThreadsFindTheRootsOfPlainOnes) {
+  BatchSolver plain(N, 1);
+  std::vector<double> c(count*(N + 1)), zr(count*N), zi(count*N);
+  fill(c.data());
+  ASSERT_THAT(plain.solve(count, N, c.data(), N + 1, zr.data(), zi.data(), N, nullptr), Eq(0));
+
+  BatchSolver numa(N, NumaTopology::simulated(3, 2));
+  double* nc = numa.allocate(count, N + 1);
+  double* nr = numa.allocate(count, N);
+  double* ni = numa.allocate(count, N);
+  fill(nc);
+  std::vector<int> found(count);
+  ASSERT_THAT(numa.solve(count, N, nc, N + 1, nr, ni, N, found.data()), Eq(0));
+  ASSERT_THAT(found, Each(Eq(N)));
+  ASSERT_THAT(std::memcmp(nr, zr.data(), count*N*sizeof(double)), Eq(0));
+  ASSERT_THAT(std::memcmp(ni, zi.data(), count*N*sizeof(double)), Eq(0));
+  numa.release(nc);
+  numa.release(nr);
+  numa.release(ni);
+}
+
+TEST_F(Batch, StridedRowsAreThoseOfAkitiAndFailedOnesNaN) {
+  // Rows of a wider matrix, and a leading coefficient of zero in row 7
+  std::ptrdiff_t cstride = N + 4, zstride = N + 3;
+  std::vector<double> c(count*cstride, 99.0), zr(count*zstride, 99.0), zi(count*zstride, 99.0);
+  std::vector<double> all(count*(N + 1));
+  fill(all.data());
+  for(int b=0; b<count; b++) std::memcpy(&c[b*cstride], &all[b*(N + 1)], (N + 1)*sizeof(double));
+  c[7*cstride] = 0.0;
+
+  BatchSolver batch(N, 3);
+  std::vector<int> found(count, -1);
+  ASSERT_THAT(batch.solve(count, N, c.data(), cstride, zr.data(), zi.data(), zstride, found.data()), Eq(1));
+  ASSERT_THAT(found[7], Eq(0));
+  for(int l=0; l<N; l++) {
+    ASSERT_TRUE(std::isnan(zr[7*zstride + l]));
+    ASSERT_TRUE(std::isnan(zi[7*zstride + l]));
+  }
+
+  Akiti akiti(N);
+  std::vector<double> r(N), i(N);
+  for(int b=0; b<count; b++) {
+    if(b == 7)   continue;
+    int n{0};
+    ASSERT_THAT(akiti.solve(&c[b*cstride], N, r.data(), i.data(), &n), Eq(RootStatus::Success));
+    ASSERT_THAT(found[b], Eq(n));
+    ASSERT_THAT(std::memcmp(&zr[b*zstride], r.data(), N*sizeof(double)), Eq(0));
+    ASSERT_THAT(std::memcmp(&zi[b*zstride], i.data(), N*sizeof(double)), Eq(0));
+    // Past the roots the rows are left alone
+    for(std::ptrdiff_t l=N; l<zstride; l++) ASSERT_THAT(zr[b*zstride + l], Eq(99.0));
+  }
+}
@@ -0,0 +1,227 @@
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <cfloat>
+
+#ifndef BezierRoots_h
+#define BezierRoots_h
+
+// Roots in [0, 1] of polynomials in Bernstein form, sum b_i C(n,i) t^i (1-t)^(n-i), as
+// Bezier segments and B-spline pieces come, without a change to the monomial basis.
+//
+// Bezier clipping: the graph of the polynomial lies in the convex hull of its control
+// points (i/n, b_i), so its roots lie where that hull meets the axis. The parameter range
+// is clipped to that interval by two de Casteljau splits, and this is repeated; the
+// clipping converges quadratically to a simple root. Where it removes less than a fifth of
+// the range, the range holds several roots or a multiple one, and it is split in halves
+// instead. A range is a root once it is narrower than tol.
+//
+// Control points within a few rounding errors of the largest one of the segment count as
+// zero, so that a double root, where the curve only touches the axis, is not lost to
+// rounding. A range whose control points are all zero in that sense is a root as a whole.
+// A range clipped narrower than tol is a root only if the curve changes sign over it or
+// comes within zero of the axis there; a control point on the axis alone, as in
+// (1-t)^2 + t^2, does not make one.
+// Root ranges that overlap or lie within tol of each other are merged and reported once,
+// at the middle, so a multiple root, and the cluster of ranges where rounding hides its
+// exact position, appear once. A polynomial that vanishes identically has no isolated
+// roots and gives none.
+//
+// The batch version takes count segments of one degree n, stored by coefficient,
+// b[i*count + s] being b_i of segment s, and returns the roots of segment s in
+// t[first[s]] ... t[first[s + 1] - 1]. The first test, whether the control points change
+// sign at all, rejects most segments of a curve; it runs on Lanes segments side by side as
+// SIMD vectors, and only the segments that remain are clipped one by one.
+
+class BezierRoots {
+  public:
+    BezierRoots(double tol = 1.0e-14, int maxDepth = 200);
+    void find(const std::vector<double>& b, std::vector<double>& t) const;
+    void find(int count, int n, const double* b, std::vector<int>& first, std::vector<double>& t) const;
+
+  private:
+    double tol;
+    int maxDepth;
+
+    static const int Lanes = 2;
+    typedef double Lane __attribute__((vector_size(Lanes*sizeof(double))));
+
+    void hull(const std::vector<double>& b, double zero, double& lo, double& hi) const;
+    void split(std::vector<double>& b, double s, std::vector<double>& right) const;
+    double value(const std::vector<double>& b, double s, std::vector<double>& w) const;
+    void clip(const std::vector<double>& b, std::vector<double>& t) const;
+};
+
+inline BezierRoots::BezierRoots(double tol, int maxDepth) : tol(tol), maxDepth(maxDepth) {}
+
+// The interval [lo, hi] of [0, 1] where the convex hull of the control points meets the
+// axis: the range of the crossings of the lines between any two of them. lo > hi if the
+// hull does not meet it. Control points of modulus at most zero are on the axis.
+inline void BezierRoots::hull(const std::vector<double>& b, double zero, double& lo, double& hi) const {
+  int n = b.size() - 1;
+  lo = 1.0;
+  hi = 0.0;
+  for(int i=0; i<=n; i++) {
+    if(std::fabs(b[i]) <= zero) {
+      lo = std::min(lo, (double)i/n);
+      hi = std::max(hi, (double)i/n);
+      continue;
+    }
+    for(int j=i+1; j<=n; j++) {
+      if((b[i] < 0.0) == (b[j] < 0.0) || std::fabs(b[j]) <= zero) continue;
+      double x = (i + (j - i)*b[i]/(b[i] - b[j]))/n;
+      lo = std::min(lo, x);
+      hi = std::max(hi, x);
+    }
+  }
+}
+
+// de Casteljau at s: b becomes the polynomial on [0, s] and right the one on [s, 1], both
+// reparametrized to [0, 1]
+inline void BezierRoots::split(std::vector<double>& b, double s, std::vector<double>& right) const {
+  int n = b.size() - 1;
+  std::vector<double> w(b);
+  right.resize(n + 1);
+  right[n] = w[n];
+  for(int k=1; k<=n; k++) {
+    for(int i=0; i<=n-k; i++) w[i] = (1.0 - s)*w[i] + s*w[i + 1];
+    b[k] = w[0];
+    right[n - k] = w[n - k];
+  }
+}
+
+// The polynomial at s by de Casteljau, with w as scratch
+inline double BezierRoots::value(const std::vector<double>& b, double s, std::vector<double>& w) const {
+  int n = b.size() - 1;
+  w.assign(b.begin(), b.end());
+  for(int k=1; k<=n; k++) {
+    for(int i=0; i<=n-k; i++) w[i] = (1.0 - s)*w[i] + s*w[i + 1];
+  }
+  return w[0];
+}
+
+// Roots of one segment, appended to t in increasing order
+inline void BezierRoots::clip(const std::vector<double>& b, std::vector<double>& t) const {
+  struct Range {
+    double a, c;
+    int depth;
+    std::vector<double> b;
+  };
+  double zero{0.0};
+  for(size_t i=0; i<b.size(); i++) zero = std::max(zero, std::fabs(b[i]));
+  if(zero == 0.0) return;
+  zero *= 4.0*b.size()*DBL_EPSILON;
+
+  std::vector<Range> stack(1);
+  stack[0].a = 0.0;
+  stack[0].c = 1.0;
+  stack[0].depth = 0;
+  stack[0].b = b;
+
+  // Ranges of roots, merged at the end
+  std::vector<std::pair<double, double> > found;
+  std::vector<double> right;
+  while(!stack.empty()) {
+    Range r;
+    r.b.swap(stack.back().b);
+    r.a = stack.back().a;
+    r.c = stack.back().c;
+    r.depth = stack.back().depth;
+    stack.pop_back();
+
+    double lo, hi;
+    hull(r.b, zero, lo, hi);
+    if(lo > hi) continue;
+    double w = r.c - r.a;
+    bool flat = true;
+    for(size_t i=0; i<r.b.size() && flat; i++) flat = (std::fabs(r.b[i]) <= zero);
+    if(flat) {
+      found.push_back(std::make_pair(r.a, r.c));
+      continue;
+    }
+    if(w*(hi - lo) <= tol || r.depth >= maxDepth) {
+      double fl = value(r.b, lo, right), fh = value(r.b, hi, right);
+      double fm = value(r.b, 0.5*(lo + hi), right);
+      if((fl < 0.0) != (fh < 0.0) || std::min(std::fabs(fm), std::min(std::fabs(fl), std::fabs(fh))) <= zero) {
+        found.push_back(std::make_pair(r.a + w*lo, r.a + w*hi));
+      }
+      continue;
+    }
+
+    if(hi - lo > 0.8) {
+      split(r.b, 0.5, right);
+      Range h;
+      h.a = r.a + 0.5*w;
+      h.c = r.c;
+      h.depth = r.depth + 1;
+      h.b.swap(right);
+      stack.push_back(h);
+      r.c = r.a + 0.5*w;
+      r.depth++;
+      stack.push_back(r);
+      continue;
+    }
+
+    // Clip to [lo, hi]: keep [0, hi], then the part of it from lo/hi on
+    if(hi < 1.0) split(r.b, hi, right);
+    if(lo > 0.0) {
+      split(r.b, lo/hi, right);
+      r.b.swap(right);
+    }
+    r.c = r.a + w*hi;
+    r.a = r.a + w*lo;
+    r.depth++;
+    stack.push_back(r);
+  }
+
+  std::sort(found.begin(), found.end());
+  for(size_t j=0; j<found.size(); ) {
+    double a = found[j].first, c = found[j].second;
+    for(j++; j<found.size() && found[j].first <= c + tol; j++) c = std::max(c, found[j].second);
+    t.push_back(0.5*(a + c));
+  }
+}
+
+inline void BezierRoots::find(const std::vector<double>& b, std::vector<double>& t) const {
+  if(b.size() < 2) {
+    throw std::invalid_argument( "A Bezier segment needs at least two control points." );
+  }
+  t.clear();
+  clip(b, t);
+}
+
+inline void BezierRoots::find(int count, int n, const double* b, std::vector<int>& first, std::vector<double>& t) const {
+  if(n < 1) {
+    throw std::invalid_argument( "A Bezier segment needs at least two control points." );
+  }
+  first.assign(count + 1, 0);
+  t.clear();
+  std::vector<double> c(n + 1);
+  const Lane zero = {0.0, 0.0};
+
+  for(int s0=0; s0<count; s0+=Lanes) {
+    // Smallest and largest control point of Lanes segments; lanes past the end repeat the
+    // last segment
+    Lane lo, hi;
+    for(int l=0; l<Lanes; l++) lo[l] = hi[l] = b[std::min(s0 + l, count - 1)];
+    for(int i=1; i<=n; i++) {
+      Lane x;
+      for(int l=0; l<Lanes; l++) x[l] = b[i*count + std::min(s0 + l, count - 1)];
+      lo = ((x < lo) ? x : lo);
+      hi = ((x > hi) ? x : hi);
+    }
+    auto crossing = ((lo <= zero) & (hi >= zero));
+
+    for(int l=0; l<Lanes && s0 + l<count; l++) {
+      int s = s0 + l;
+      if(crossing[l] != 0) {
+        for(int i=0; i<=n; i++) c[i] = b[i*count + s];
+        clip(c, t);
+      }
+      first[s + 1] = t.size();
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,260 @@
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#ifndef CauchySum_h
+#define CauchySum_h
+
+// Cauchy sums over m source points x_j with weights a_j,
+//
+//   s1(t) = sum_j a_j/(t - x_j),   s2(t) = sum_j a_j/(t - x_j)^2,
+//
+// in O(log m) per target t by a Barnes-Hut quadtree with multipole expansions. A cell with
+// centre c contributes
+//
+//   sum_j a_j/(t - x_j) = sum_(k >= 0) A_k/(t - c)^(k+1),   A_k = sum_j a_j (x_j - c)^k
+//
+// to a target far from it, truncated after order terms, and s2 = -s1' follows from the
+// same moments. A cell counts as far once its radius is at most theta times the distance
+// from t to its centre, so the relative error of an expansion is about theta^order. Near
+// cells are summed directly.
+//
+// The order is at most MaxOrder, so that the powers of a far expansion live on the stack.
+// Up to four sets of weights on the same points share one tree. Without weights every a_j
+// is one; evaluate then gives the sums sum_(j != i) 1/(z_i - z_j) of n points among each
+// other in O(n log n). After build the sums may be taken from several threads.
+//
+// The work of a sum is counted in terms: order for every far cell and one for every point
+// of a near leaf. getWork gives the terms of the last evaluate, about n log n.
+
+class CauchySum {
+  public:
+    static const int MaxOrder = 64;
+
+    CauchySum(int order = 20, double theta = 0.4);
+    void evaluate(int n, const std::complex<double>* z, std::complex<double>* s);
+    void build(int m, const std::complex<double>* x, int sets = 1, const std::complex<double>* const* weight = nullptr);
+    std::complex<double> sum(int i, long* work = nullptr) const;
+    void sums(std::complex<double> t, int skip, std::complex<double>* s1, std::complex<double>* s2,
+              long* work = nullptr) const;
+    long getWork(void) const;
+
+  private:
+    typedef std::complex<double> Complex;
+
+    struct Cell {
+      Complex centre;
+      double radius;
+      int first, count;
+      int child[4];
+    };
+
+    int order;
+    double theta;
+    int leafSize{16};
+    int maxDepth{40};
+    long work{0};
+
+    const Complex* x{nullptr};
+    int m{0};
+    int sets{1};
+    std::vector<Complex> a;
+    std::vector<Cell> cells;
+    std::vector<int> perm;
+    std::vector<Complex> moment;
+
+    int split(int first, int count, double cx, double cy, double half, int depth);
+    static Complex inverse(Complex d);
+};
+
+inline CauchySum::CauchySum(int order, double theta) : order(order), theta(theta) {
+  if(order < 1 || order > MaxOrder) {
+    throw std::invalid_argument( "The order of the expansions must be between 1 and 64." );
+  }
+}
+
+// 1/d without the scaling of the library's complex division; d is neither tiny nor huge
+inline CauchySum::Complex CauchySum::inverse(Complex d) {
+  double n = d.real()*d.real() + d.imag()*d.imag();
+  return Complex(d.real()/n, -d.imag()/n);
+}
+
+// Cell over perm[first, first+count) in the square of centre (cx, cy) and half width
+// half. Returns its index in cells.
+inline int CauchySum::split(int first, int count, double cx, double cy, double half, int depth) {
+  int c = cells.size();
+  cells.push_back(Cell());
+  cells[c].first = first;
+  cells[c].count = count;
+  for(int q=0; q<4; q++) cells[c].child[q] = -1;
+
+  Complex centre(0.0, 0.0);
+  for(int j=first; j<first+count; j++) centre += x[perm[j]];
+  centre /= (double)count;
+  double radius{0.0};
+  for(int j=first; j<first+count; j++) radius = std::max(radius, std::norm(x[perm[j]] - centre));
+  radius = std::sqrt(radius);
+  cells[c].centre = centre;
+  cells[c].radius = radius;
+
+  // Moments of every weight set, stored as moment[(c*sets + set)*order + k]
+  moment.resize(cells.size()*sets*order);
+  Complex* A = &moment[c*sets*order];
+  for(int k=0; k<sets*order; k++) A[k] = 0.0;
+  // In real arithmetic: the complex operators check for infinities on every product
+  for(int j=first; j<first+count; j++) {
+    Complex d = x[perm[j]] - centre;
+    double dr = d.real(), di = d.imag(), pr = 1.0, pi = 0.0;
+    for(int k=0; k<order; k++) {
+      for(int s=0; s<sets; s++) {
+        Complex aj = a[s*m + perm[j]];
+        A[s*order + k] += Complex(aj.real()*pr - aj.imag()*pi, aj.real()*pi + aj.imag()*pr);
+      }
+      double t = pr*dr - pi*di;
+      pi = pr*di + pi*dr;
+      pr = t;
+    }
+  }
+
+  if(count <= leafSize || depth >= maxDepth || radius == 0.0) return c;
+
+  // Partition into the quadrants: left/right, then bottom/top within each
+  int* p = &perm[first];
+  const Complex* xs = x;
+  int mid = std::partition(p, p + count, [&](int j) { return xs[j].real() < cx; }) - p;
+  int lo  = std::partition(p, p + mid, [&](int j) { return xs[j].imag() < cy; }) - p;
+  int hi  = std::partition(p + mid, p + count, [&](int j) { return xs[j].imag() < cy; }) - p;
+  int bounds[5] = {0, lo, mid, hi, count};
+  double h = 0.5*half;
+  double qx[4] = {cx - h, cx - h, cx + h, cx + h};
+  double qy[4] = {cy - h, cy + h, cy - h, cy + h};
+  for(int q=0; q<4; q++) {
+    if(bounds[q + 1] > bounds[q]) {
+      int child = split(first + bounds[q], bounds[q + 1] - bounds[q], qx[q], qy[q], h, depth + 1);
+      cells[c].child[q] = child;
+    }
+  }
+  return c;
+}
+
+// Tree over the m points x with sets weight vectors weight[0], ..., weight[sets-1]; all
+// weights are one if weight is null
+inline void CauchySum::build(int m, const Complex* x, int sets, const Complex* const* weight) {
+  this->x = x;
+  this->m = m;
+  this->sets = sets;
+  cells.clear();
+  moment.clear();
+  if(m <= 0) return;
+
+  a.resize(sets*m);
+  for(int s=0; s<sets; s++) {
+    for(int j=0; j<m; j++) a[s*m + j] = ((weight == nullptr) ? Complex(1.0, 0.0) : weight[s][j]);
+  }
+
+  perm.resize(m);
+  double xmin = x[0].real(), xmax = xmin, ymin = x[0].imag(), ymax = ymin;
+  for(int j=0; j<m; j++) {
+    perm[j] = j;
+    xmin = std::min(xmin, x[j].real());
+    xmax = std::max(xmax, x[j].real());
+    ymin = std::min(ymin, x[j].imag());
+    ymax = std::max(ymax, x[j].imag());
+  }
+  double half = 0.5*std::max(xmax - xmin, ymax - ymin);
+  split(0, m, 0.5*(xmin + xmax), 0.5*(ymin + ymax), half, 0);
+}
+
+// s1 and s2 of every weight set at t, leaving out the source skip; the terms are added to
+// work if it is given
+inline void CauchySum::sums(Complex t, int skip, Complex* s1, Complex* s2, long* work) const {
+  for(int s=0; s<sets; s++) s1[s] = s2[s] = 0.0;
+  if(cells.empty()) return;
+
+  // Each level of the tree pushes at most four cells
+  int stack[4*64];
+  // Called once per target in every sweep, so nothing here allocates
+  double power[2*MaxOrder];
+  long terms{0};
+  int top = 0;
+  stack[top++] = 0;
+  while(top > 0) {
+    int c = stack[--top];
+    const Cell& cell = cells[c];
+
+    Complex d = t - cell.centre;
+    double dist2 = std::norm(d);
+    if(dist2 > 0.0 && cell.radius*cell.radius <= theta*theta*dist2) {
+      // Far: the expansions in w = 1/(t - c), with the powers of w shared by the sets
+      Complex w = inverse(d);
+      terms += order;
+      double wr = w.real(), wi = w.imag(), pr = wr, pi = wi;
+      for(int k=0; k<order; k++) {
+        power[2*k] = pr;
+        power[2*k + 1] = pi;
+        double u = pr*wr - pi*wi;
+        pi = pr*wi + pi*wr;
+        pr = u;
+      }
+      for(int s=0; s<sets; s++) {
+        const Complex* A = &moment[(c*sets + s)*order];
+        double t1r = 0.0, t1i = 0.0, t2r = 0.0, t2i = 0.0;
+        for(int k=0; k<order; k++) {
+          double ar = A[k].real(), ai = A[k].imag();
+          double tr = ar*power[2*k] - ai*power[2*k + 1];
+          double ti = ar*power[2*k + 1] + ai*power[2*k];
+          t1r += tr;
+          t1i += ti;
+          t2r += (k + 1)*tr;
+          t2i += (k + 1)*ti;
+        }
+        s1[s] += Complex(t1r, t1i);
+        s2[s] += Complex(t2r*wr - t2i*wi, t2r*wi + t2i*wr);
+      }
+      continue;
+    }
+
+    bool leaf = true;
+    for(int q=0; q<4; q++) {
+      if(cell.child[q] >= 0) {
+        stack[top++] = cell.child[q];
+        leaf = false;
+      }
+    }
+    if(leaf) {
+      terms += cell.count;
+      for(int j=cell.first; j<cell.first+cell.count; j++) {
+        int k = perm[j];
+        if(k == skip) continue;
+        Complex r = inverse(t - x[k]);
+        for(int s=0; s<sets; s++) {
+          s1[s] += a[s*m + k]*r;
+          s2[s] += a[s*m + k]*r*r;
+        }
+      }
+    }
+  }
+  if(work != nullptr)   *work += terms;
+}
+
+// sum_(j != i) 1/(x_i - x_j) for the first weight set
+inline std::complex<double> CauchySum::sum(int i, long* work) const {
+  Complex s1[4], s2[4];
+  sums(x[i], i, s1, s2, work);
+  return s1[0];
+}
+
+inline void CauchySum::evaluate(int n, const Complex* z, Complex* s) {
+  build(n, z);
+  work = 0;
+  for(int i=0; i<n; i++) s[i] = sum(i, &work);
+}
+
+// Terms summed by the last evaluate
+inline long CauchySum::getWork(void) const {
+  return work;
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include "croots.h"
+
+#include "akiti.h"
+#include "batch.h"
+
+#include <vector>
+#include <limits>
+
+// The handle: the solver of the single solve and the workspaces of the batch, kept at
+// their largest size
+struct roots_solver {
+  int maxDegree;
+  Akiti akiti;
+  BatchSolver batch;
+
+  roots_solver(int maxDegree, int threads) : maxDegree(maxDegree), akiti(maxDegree), batch(maxDegree, threads) {}
+};
+
+namespace {
+
+roots_status toStatus(RootStatus status) {
+  switch(status) {
+    case RootStatus::Success:                return ROOTS_SUCCESS;
+    case RootStatus::DegreeTooLarge:         return ROOTS_DEGREE_TOO_LARGE;
+    case RootStatus::LeadingCoefficientZero: return ROOTS_LEADING_COEFFICIENT_ZERO;
+    case RootStatus::NoConvergence:          return ROOTS_NO_CONVERGENCE;
+  }
+  return ROOTS_INVALID_ARGUMENT;
+}
+
+}
+
+extern "C" {
+
+roots_solver* roots_create(int max_degree, int threads) {
+  if(max_degree < 1 || threads < 0) return nullptr;
+  try {
+    return new roots_solver(max_degree, threads);
+  }
+  catch (const std::exception&) {
+    return nullptr;
+  }
+}
+
+void roots_destroy(roots_solver* solver) {
+  delete solver;
+}
+
+int roots_max_degree(const roots_solver* solver) {
+  return ((solver != nullptr) ? solver->maxDegree : 0);
+}
+
+roots_status roots_set_accuracy(roots_solver* solver, double rtol, double atol) {
+  if(solver == nullptr || !(rtol >= 0.0) || !(atol >= 0.0)) return ROOTS_INVALID_ARGUMENT;
+  solver->akiti.setAccuracy(rtol, atol);
+  solver->batch.setAccuracy(rtol, atol);
+  return ROOTS_SUCCESS;
+}
+
+roots_status roots_solve(roots_solver* solver, const double* coeff, int N, double* zr, double* zi, int* found) {
+  if(solver == nullptr || coeff == nullptr || zr == nullptr || zi == nullptr || N < 1) return ROOTS_INVALID_ARGUMENT;
+  if(N > solver->maxDegree) {
+    if(found != nullptr)   *found = 0;
+    return ROOTS_DEGREE_TOO_LARGE;
+  }
+
+  // Straight into the arrays of the caller: Akiti solves in the workspace of the handle,
+  // without allocating, and only reads the coefficients
+  int n{0};
+  RootStatus status = solver->akiti.solve(const_cast<double*>(coeff), N, zr, zi, &n);
+  for(int j=n; j<N; j++) zr[j] = zi[j] = std::numeric_limits<double>::quiet_NaN();
+  if(found != nullptr)   *found = n;
+  return toStatus(status);
+}
+
+roots_status roots_solve_batch(roots_solver* solver, int count, int N, const double* coeff, ptrdiff_t cstride,
+                               double* zr, double* zi, ptrdiff_t zstride, int* found, int* failed) {
+  if(solver == nullptr || count < 0 || N < 1) return ROOTS_INVALID_ARGUMENT;
+  if(count > 0 && (coeff == nullptr || zr == nullptr || zi == nullptr)) return ROOTS_INVALID_ARGUMENT;
+  if(N > solver->maxDegree) return ROOTS_DEGREE_TOO_LARGE;
+  try {
+    int f = solver->batch.solve(count, N, coeff, cstride, zr, zi, zstride, found);
+    if(failed != nullptr)   *failed = f;
+  }
+  catch (const std::exception&) {
+    // Threads that could not be started
+    return ROOTS_OUT_OF_MEMORY;
+  }
+  return ROOTS_SUCCESS;
+}
+
+}
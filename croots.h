@@ -0,0 +1,62 @@
+#include <stddef.h>
+
+#ifndef CRoots_h
+#define CRoots_h
+
+// C interface of the solver, for callers from C, Fortran (bind(C)), Julia (ccall) and the
+// like, in the shared library croots.
+//
+// A roots_solver is an opaque handle that owns the workspaces of the solver: one for the
+// single solve and one per thread for the batch, allocated once for polynomials of degree
+// up to max_degree and reused on every call. A handle is used by one caller at a time;
+// separate handles are independent.
+//
+// Coefficients come leading one first. Roots and counts are written to caller-owned
+// arrays of N places per polynomial, NaN where no root was found, and nothing is handed
+// back to be freed. Every function returns a roots_status,
+// and a handle of NULL from roots_create means it could not be allocated.
+//
+// roots_solve_batch solves count polynomials of degree N: polynomial b has its N+1
+// coefficients at coeff + b*cstride, and its roots go to zr + b*zstride and
+// zi + b*zstride, the strides counting doubles. The columns of a Fortran array
+// coeff(N+1, count) have cstride = N+1, as do the rows of a C array [count][N+1]. found,
+// if not NULL, gets the number of roots found for each polynomial, and failed, if not
+// NULL, the number of polynomials not solved completely.
+
+// Only these functions are exported; the C++ classes behind them stay inside the library
+#if defined(__GNUC__)
+#define ROOTS_API __attribute__((visibility("default")))
+#else
+#define ROOTS_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct roots_solver roots_solver;
+
+typedef enum {
+  ROOTS_SUCCESS = 0,
+  ROOTS_DEGREE_TOO_LARGE = 1,
+  ROOTS_LEADING_COEFFICIENT_ZERO = 2,
+  ROOTS_NO_CONVERGENCE = 3,
+  ROOTS_INVALID_ARGUMENT = 4,
+  ROOTS_OUT_OF_MEMORY = 5
+} roots_status;
+
+ROOTS_API roots_solver* roots_create(int max_degree, int threads);
+ROOTS_API void roots_destroy(roots_solver* solver);
+
+ROOTS_API int roots_max_degree(const roots_solver* solver);
+ROOTS_API roots_status roots_set_accuracy(roots_solver* solver, double rtol, double atol);
+
+ROOTS_API roots_status roots_solve(roots_solver* solver, const double* coeff, int N, double* zr, double* zi, int* found);
+ROOTS_API roots_status roots_solve_batch(roots_solver* solver, int count, int N, const double* coeff, ptrdiff_t cstride,
+                                         double* zr, double* zi, ptrdiff_t zstride, int* found, int* failed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,111 @@
+#include "gmock/gmock.h"
+
+#include "croots.h"
+#include "akiti.h"
+#include "roots.h"
+
+#include <vector>
+#include <cmath>
+#include <complex>
+
+using namespace testing;
+
+class CRoots: public Test {
+  public:
+    roots_solver* solver{nullptr};
+    // (x - 1)(x - 2)(x - 3)(x^2 + 1)
+    std::vector<double> coeff = {1.0, -6.0, 12.0, -12.0, 11.0, -6.0};
+
+    void SetUp() override {
+      solver = roots_create(10, 2);
+    }
+
+    void TearDown() override {
+      roots_destroy(solver);
+    }
+};
+
+TEST_F(CRoots, HandleKeepsMaximalDegree) {
+  ASSERT_THAT(solver, Ne(nullptr));
+  ASSERT_THAT(roots_max_degree(solver), Eq(10));
+  ASSERT_THAT(roots_create(0, 1), Eq(nullptr));
+}
+
+// The handle and Roots in this translation unit share the definitions of the headers
+TEST_F(CRoots, SolveMatchesRoots) {
+  std::vector<double> zr(5), zi(5);
+  int found;
+  ASSERT_THAT(roots_solve(solver, coeff.data(), 5, zr.data(), zi.data(), &found), Eq(ROOTS_SUCCESS));
+  ASSERT_THAT(found, Eq(5));
+
+  Akiti akiti(10);
+  Roots rootfinder(&akiti);
+  int degree;
+  std::vector<double> wr, wi;
+  rootfinder.findRoots(coeff);
+  rootfinder.getRoots(degree, wr, wi);
+  for(int j=0; j<5; j++) {
+    ASSERT_THAT(zr[j], DoubleNear(wr[j], 1.0e-12));
+    ASSERT_THAT(zi[j], DoubleNear(wi[j], 1.0e-12));
+  }
+}
+
+// The roots of a polynomial of the largest degree fill the buffers of the handle exactly
+TEST_F(CRoots, SolveAtMaximalDegree) {
+  roots_solver* small = roots_create(5, 1);
+  ASSERT_THAT(small, Ne(nullptr));
+  std::vector<double> zr(5), zi(5);
+  int found;
+  ASSERT_THAT(roots_solve(small, coeff.data(), 5, zr.data(), zi.data(), &found), Eq(ROOTS_SUCCESS));
+  ASSERT_THAT(found, Eq(5));
+  for(int j=0; j<5; j++) {
+    std::complex<double> z(zr[j], zi[j]), p(0.0, 0.0);
+    for(double c : coeff) p = p*z + c;
+    EXPECT_THAT(std::abs(p), Lt(1.0e-10));
+  }
+  roots_destroy(small);
+}
+
+TEST_F(CRoots, SolveReportsStatusWithoutThrowing) {
+  std::vector<double> zr(5), zi(5);
+  int found{-1};
+  std::vector<double> zero = {0.0, 1.0, 2.0, 3.0, 4.0, 5.0};
+  ASSERT_THAT(roots_solve(solver, zero.data(), 5, zr.data(), zi.data(), &found), Eq(ROOTS_LEADING_COEFFICIENT_ZERO));
+  ASSERT_THAT(found, Eq(0));
+  ASSERT_TRUE(std::isnan(zr[0]));
+
+  std::vector<double> big(12, 1.0), br(11), bi(11);
+  ASSERT_THAT(roots_solve(solver, big.data(), 11, br.data(), bi.data(), &found), Eq(ROOTS_DEGREE_TOO_LARGE));
+  ASSERT_THAT(roots_solve(nullptr, coeff.data(), 5, zr.data(), zi.data(), &found), Eq(ROOTS_INVALID_ARGUMENT));
+}
+
+// Every other column of a Fortran array c(6, 2*count), into every other column of z(5, 2*count)
+TEST_F(CRoots, BatchSolvesStridedColumnsInPlace) {
+  int count = 40;
+  std::vector<double> c(12*count, 0.0), zr(10*count, 0.0), zi(10*count, 0.0);
+  std::vector<int> found(count);
+  for(int b=0; b<count; b++) {
+    for(int i=0; i<6; i++) c[12*b + i] = coeff[i]*(1.0 + b);
+  }
+  c[12*7] = 0.0;
+
+  int failed;
+  ASSERT_THAT(roots_solve_batch(solver, count, 5, c.data(), 12, zr.data(), zi.data(), 10, found.data(), &failed),
+              Eq(ROOTS_SUCCESS));
+  ASSERT_THAT(failed, Eq(1));
+  ASSERT_THAT(found[7], Eq(0));
+  ASSERT_TRUE(std::isnan(zr[10*7]));
+
+  std::vector<double> wr(5), wi(5);
+  roots_solve(solver, coeff.data(), 5, wr.data(), wi.data(), nullptr);
+  for(int b=0; b<count; b++) {
+    if(b == 7) continue;
+    ASSERT_THAT(found[b], Eq(5));
+    for(int j=0; j<5; j++) {
+      ASSERT_THAT(zr[10*b + j], DoubleNear(wr[j], 1.0e-10));
+      ASSERT_THAT(zi[10*b + j], DoubleNear(wi[j], 1.0e-10));
+      // The columns in between are not touched
+      ASSERT_THAT(zr[10*b + 5 + j], Eq(0.0));
+    }
+  }
+}
@@ -0,0 +1,431 @@
+// Ehrlich-Aberth iteration for polynomials of very high degree, 10^5 and beyond.
+//
+// The Gauss-Seidel sweep of Aberth spends O(N^2) on the sums sum_(j != i) 1/(z_i - z_j)
+// and as much again on evaluating p and p' by Horner's rule at every approximation. Here
+// all approximations are updated together, Jacobi style, so that both become multipoint
+// problems over one fixed set of points:
+//
+// - The sums come from the multipole quadtree of CauchySum in O(N log N).
+//
+// - Approximations whose moduli are close to a common radius r share one evaluation. An
+//   FFT of length M > N gives the values f_k = p(r w^k) at the M-th roots of unity w^k, and
+//   the barycentric formula for these nodes,
+//
+//     p(r u) = A(u)/B(u),   A(u) = sum_k f_k w^k/(u - w^k),   B(u) = sum_k w^k/(u - w^k),
+//
+//   with p'/p = (B2/B - A2/A)/r from the sums A2, B2 over (u - w^k)^2, is again a Cauchy sum
+//   over the nodes. Outside the circle the reversed polynomial u^N p(r/u), whose values at
+//   the nodes come from the same FFT, is interpolated instead, so the formula is only used
+//   where it is stable. Coefficients are scaled by the powers of r first, so nothing
+//   overflows. corrections chooses the circles from the sorted moduli so that each is
+//   accurate to the rounding error of Horner's rule on the approximations it serves, and
+//   only uses a circle where it serves enough of them to pay for its FFT and tree.
+//
+// The other approximations are evaluated by Horner's rule, on the reversed polynomial in
+// 1/z outside the unit disk so that no power of z overflows. Only approximations that have
+// not converged are evaluated, and the work of a sweep is spread over threads.
+//
+// Coefficients are only read, so op may point into a MappedPoly.
+
+#include <cmath>
+#include <cfloat>
+#include <complex>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "aberth.h"
+#include "cauchy.h"
+#include "fft.h"
+
+#ifndef FastAberth_h
+#define FastAberth_h
+
+class FastAberth: public Aberth {
+  public:
+    FastAberth(int degree, int maxIter = 500, int threads = 0);
+
+    const char* name(void) const override { return "fastaberth"; };
+    RootStatus solve(double* op, int Degree, double* zeror, double* zeroi, int* found) noexcept override;
+    int getSweepCount(void) const;
+
+  private:
+    typedef std::complex<double> Complex;
+
+    int threads;
+    int sweeps{0};
+    CauchySum cauchy;
+    std::vector<int> active;
+    std::vector<Complex> w;
+
+    // Evaluation on circles: the nodes w^k, the values and the barycentric weights
+    FFT fft;
+    CauchySum interp{30, 0.4};
+    std::vector<Complex> nodes, f, fw;
+    std::vector<int> order;
+    std::vector<double> xs;
+
+    int iterate(const double* op, int N, double* zeror, double* zeroi);
+    void corrections(const double* op, int N);
+    void ringCorrections(const double* op, int N, double lr, const int* list, int n, double xlo, double xhi);
+    double logBound(const double* op, int N, double x, double* slope = nullptr) const;
+    bool newton(const double* op, int N, Complex x, Complex& r) const;
+    template<class Body> void parallelFor(int n, Body body) const;
+};
+
+// threads = 0 uses all hardware threads
+inline FastAberth::FastAberth(int degree, int maxIter, int threads) : Aberth(degree, maxIter), threads(threads) {
+  if(this->threads <= 0)   this->threads = std::thread::hardware_concurrency();
+  if(this->threads <= 0)   this->threads = 1;
+}
+
+// Sweeps taken by the last solve
+inline int FastAberth::getSweepCount(void) const {
+  return sweeps;
+}
+
+inline RootStatus FastAberth::solve(double op[], int Degree, double zeror[], double zeroi[], int* found) noexcept {
+  *found = 0;
+  sweeps = 0;
+  if (Degree > RPoly::maxDegree)   return RootStatus::DegreeTooLarge;
+  if (op[0] == 0.0)         return RootStatus::LeadingCoefficientZero;
+
+  // Remove zeros at the origin, if any
+  int N = Degree;
+  int j = 0;
+  while (N > 0 && op[N] == 0.0){
+    zeror[j] = zeroi[j] = 0.0;
+    N--;
+    j++;
+  }
+
+  if (N > 0){
+    int n;
+    try {
+      moduli.estimate(op, N, radius);
+      n = iterate(op, N, &zeror[j], &zeroi[j]);
+    }
+    catch (...) {
+      // Out of memory or threads for the estimates or the work arrays
+      *found = j;
+      return RootStatus::NoConvergence;
+    }
+    if (n < N){
+      *found = j + n;
+      return RootStatus::NoConvergence;
+    }
+  }
+
+  *found = Degree;
+  return RootStatus::Success;
+}
+
+// Splits [0, n) into one contiguous block per thread
+template<class Body> void FastAberth::parallelFor(int n, Body body) const {
+  int t = ((n < 256*threads) ? (n + 255)/256 : threads);
+  if (t <= 1){
+    body(0, n);
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  int chunk = (n + t - 1)/t;
+  for (int k = 1; k < t; k++){
+    int lo = k*chunk, hi = ((lo + chunk < n) ? lo + chunk : n);
+    if (lo >= hi)   continue;
+    try {
+      workers.push_back(std::thread(body, lo, hi));
+    }
+    catch (...) {
+      // No thread to spare: do the block here
+      body(lo, hi);
+    }
+  }
+  body(0, ((chunk < n) ? chunk : n));
+  for (size_t k = 0; k < workers.size(); k++)   workers[k].join();
+}
+
+// True if p(x) is at the level of its rounding error. Otherwise r is the Newton
+// correction p(x)/p'(x); for |x| > 1 it follows from q(y) = y^N p(1/y) at y = 1/x as
+// p'/p = y (N - y q'(y)/q(y)).
+inline bool FastAberth::newton(const double* op, int N, Complex x, Complex& r) const {
+  double ax = std::abs(x);
+  std::complex<double> px, dpx, ratio;
+  double b;
+
+  if (ax <= 1.0){
+    px  = op[0];
+    dpx = 0.0;
+    b   = fabs(op[0]);
+    for (int i = 1; i <= N; i++){
+      dpx = dpx*x + px;
+      px  = px*x + op[i];
+      b   = b*ax + fabs(op[i]);
+    }
+    if (std::abs(px) <= N*DBL_EPSILON*b)   return true;
+    ratio = dpx/px;
+  }
+  else {
+    std::complex<double> y = 1.0/x;
+    double ay = 1.0/ax;
+    px  = op[N];
+    dpx = 0.0;
+    b   = fabs(op[N]);
+    for (int i = N - 1; i >= 0; i--){
+      dpx = dpx*y + px;
+      px  = px*y + op[i];
+      b   = b*ay + fabs(op[i]);
+    }
+    if (std::abs(px) <= N*DBL_EPSILON*b)   return true;
+    ratio = y*((double)N - y*dpx/px);
+  }
+
+  if (ratio == 0.0){
+    // Stationary point: nudge the approximation off it
+    r = std::polar((ax > 0.0 ? ax : 1.0)*sqrt(DBL_EPSILON), 1.0 + ax);
+  }
+  else {
+    r = 1.0/ratio;
+  }
+  return false;
+}
+
+// log of the rounding error bound sum |C(N-e)| |z|^e of p at log|z| = x, and optionally
+// its derivative with respect to x
+inline double FastAberth::logBound(const double* op, int N, double x, double* slope) const {
+  double lmax = -HUGE_VAL;
+  for (int e = 0; e <= N; e++){
+    if (op[N - e] != 0.0)   lmax = std::max(lmax, log(fabs(op[N - e])) + e*x);
+  }
+  double sum = 0.0, moment = 0.0;
+  for (int e = 0; e <= N; e++){
+    if (op[N - e] == 0.0)   continue;
+    double t = exp(log(fabs(op[N - e])) + e*x - lmax);
+    sum += t;
+    moment += e*t;
+  }
+  if (slope != nullptr)   *slope = moment/sum;
+  return lmax + log(sum);
+}
+
+// Aberth corrections w[k] of the active approximations at the positions of this sweep
+inline void FastAberth::corrections(const double* op, int N) {
+  int n = active.size();
+  int M = 1;
+  while (M < N + 1)   M <<= 1;
+
+  // An evaluation on the circle |z| = r is accurate to about log M eps b(r), b the bound
+  // of logBound, and serves the approximations where this is within the rounding error
+  // bound N eps b(|z|) of Horner's rule, that is where the loss
+  //
+  //   b(r)/b(|z|)                 for |z| <= r
+  //   b(r) (|z|/r)^N/b(|z|)       for |z| > r, interpolating the reversed polynomial
+  //
+  // is at most N/(4 log2 M). A circle pays when Horner on its approximations would cost
+  // more than the tree over its nodes and the sums, measured in steps of Horner's rule.
+  const double nodeCost = 700.0, sumCost = 4500.0;
+  double logK = log(N/(4.0*log2((double)M)));
+  std::vector<int> horner;
+
+  order.resize(n);
+  xs.resize(n);
+  int zero = 0;
+  for (int k = 0; k < n; k++){
+    double az = std::abs(z[active[k]]);
+    if ((az == 0.0) || (logK <= 0.0) || (n*(N - sumCost) <= nodeCost*M)){
+      horner.push_back(k);
+      zero++;
+    }
+    else {
+      order[k - zero] = k;
+      xs[k] = log(az);
+    }
+  }
+  order.resize(n - zero);
+  std::sort(order.begin(), order.end(), [&](int a, int b){ return xs[a] < xs[b]; });
+
+  int m = order.size();
+  int first = 0;
+  while (first < m){
+    double x0 = xs[order[first]];
+    double b0 = logBound(op, N, x0);
+
+    // Largest radius above the smallest modulus that still serves it
+    double lo = x0, hi = x0 + 1.0;
+    while (logBound(op, N, hi) - b0 <= logK)   hi += 1.0;
+    for (int it = 0; it < 30; it++){
+      double mid = 0.5*(lo + hi);
+      if (logBound(op, N, mid) - b0 <= logK)   lo = mid;
+      else                                      hi = mid;
+    }
+    double lr = lo;
+    double br = logBound(op, N, lr);
+
+    // Last approximation the circle serves
+    int a = first, c = m;
+    while (c - a > 1){
+      int mid = (a + c)/2;
+      double x = xs[order[mid]];
+      double loss = br + ((x > lr) ? N*(x - lr) : 0.0) - logBound(op, N, x);
+      if (loss <= logK)   a = mid;
+      else                c = mid;
+    }
+
+    int count = a - first + 1;
+    if (count*(N - sumCost) > nodeCost*M){
+      ringCorrections(op, N, lr, &order[first], count, x0, xs[order[a]]);
+    }
+    else {
+      horner.insert(horner.end(), order.begin() + first, order.begin() + a + 1);
+    }
+    first = a + 1;
+  }
+
+  parallelFor(horner.size(), [&](int lo, int hi){
+    for (int h = lo; h < hi; h++){
+      int k = horner[h];
+      int i = active[k];
+      Complex r;
+      if (newton(op, N, z[i], r)){
+        w[k] = 0.0;
+      }
+      else {
+        w[k] = r/(1.0 - r*cauchy.sum(i));
+      }
+    }
+  });
+}
+
+// Corrections of the n approximations list[], with log moduli in [xlo, xhi], by the FFT on
+// the circle of radius exp(lr) and the barycentric formula
+inline void FastAberth::ringCorrections(const double* op, int N, double lr, const int* list, int n, double xlo, double xhi) {
+  const double pi = 3.14159265358979323846;
+  int M = 1;
+  while (M < N + 1)   M <<= 1;
+  double r = exp(lr);
+
+  // g_e = C(N-e) r^e/sigma in the order of the exponent e, sigma the largest of them
+  double lmax = -HUGE_VAL;
+  for (int e = 0; e <= N; e++){
+    if (op[N - e] != 0.0)   lmax = std::max(lmax, log(fabs(op[N - e])) + e*lr);
+  }
+  f.assign(M, 0.0);
+  for (int e = 0; e <= N; e++){
+    if (op[N - e] == 0.0)   continue;
+    double g = exp(log(fabs(op[N - e])) + e*lr - lmax);
+    f[e] = ((op[N - e] < 0.0) ? -g : g);
+  }
+
+  // Values at the nodes: p(r w^k)/sigma, and q(w^k) = w^(kN) p(r w^-k)/sigma for the
+  // reversed polynomial q(y) = y^N p(r/y)/sigma
+  fft.transform(f, 1);
+  if ((int)nodes.size() != M){
+    nodes.resize(M);
+    for (int j = 0; j < M; j++)   nodes[j] = std::polar(1.0, 2.0*pi*j/M);
+  }
+  fw.resize(2*M);
+  for (int j = 0; j < M; j++){
+    fw[j] = f[j]*nodes[j];
+    fw[M + j] = nodes[(int)(((long)j*N) % M)]*f[(M - j) % M]*nodes[j];
+  }
+  const Complex* weight[3] = {fw.data(), &fw[M], nodes.data()};
+  interp.build(M, nodes.data(), 3, weight);
+
+  // log b(|z|) by interpolation in a table over [xlo, xhi]. log b is convex in log|z|, so
+  // a chord lies above it by at most (s1 - s0)(x1 - x0)/4 for the slopes s0, s1 at its
+  // ends. The table is refined until that is below 0.05, so the residual test is at
+  // most 5% too lenient.
+  std::vector<double> tx(2), tb(2), ts(2);
+  tx[0] = xlo;
+  tx[1] = xhi;
+  tb[0] = logBound(op, N, xlo, &ts[0]);
+  tb[1] = logBound(op, N, xhi, &ts[1]);
+  for (size_t t = 0; t + 1 < tx.size(); ){
+    if ((ts[t + 1] - ts[t])*(tx[t + 1] - tx[t]) <= 0.2 || tx.size() >= 1024){
+      t++;
+      continue;
+    }
+    double xm = 0.5*(tx[t] + tx[t + 1]), sm;
+    double bm = logBound(op, N, xm, &sm);
+    tx.insert(tx.begin() + t + 1, xm);
+    tb.insert(tb.begin() + t + 1, bm);
+    ts.insert(ts.begin() + t + 1, sm);
+  }
+
+  parallelFor(n, [&](int lo, int hi){
+    for (int h = lo; h < hi; h++){
+      int k = list[h];
+      int i = active[k];
+      Complex u = z[i]/r, s1[4], s2[4], ratio;
+      double lp;
+
+      if (std::abs(u) <= 1.0){
+        interp.sums(u, -1, s1, s2);
+        // p(ru)/sigma = A/B and p'/p = (B2/B - A2/A)/r
+        lp = log(std::abs(s1[0])) - log(std::abs(s1[2]));
+        ratio = (s2[2]/s1[2] - s2[0]/s1[0])/r;
+      }
+      else {
+        // The same for q at y = 1/u, then p'/p = y (N - y q'/q)/r
+        Complex y = 1.0/u;
+        interp.sums(y, -1, s1, s2);
+        lp = log(std::abs(s1[1])) - log(std::abs(s1[2])) + N*log(std::abs(u));
+        ratio = y*((double)N - y*(s2[2]/s1[2] - s2[1]/s1[1]))/r;
+      }
+
+      double x = log(std::abs(z[i]));
+      int t = std::upper_bound(tx.begin(), tx.end(), x) - tx.begin() - 1;
+      t = std::min(std::max(t, 0), (int)tx.size() - 2);
+      double lb = ((tx[t + 1] > tx[t]) ? tb[t] + (x - tx[t])*(tb[t + 1] - tb[t])/(tx[t + 1] - tx[t]) : tb[t]);
+
+      Complex rn = 1.0/ratio;
+      if (lmax + lp <= log(N*DBL_EPSILON) + lb){
+        w[k] = 0.0;
+      }
+      else if (std::isfinite(rn.real()) && std::isfinite(rn.imag())){
+        w[k] = rn/(1.0 - rn*cauchy.sum(i));
+      }
+      else if (newton(op, N, z[i], rn)){
+        // A target on a node: fall back to Horner's rule
+        w[k] = 0.0;
+      }
+      else {
+        w[k] = rn/(1.0 - rn*cauchy.sum(i));
+      }
+    }
+  });
+}
+
+// Returns the number of roots found. On failure to converge the roots found are moved to
+// the front of zeror, zeroi.
+inline int FastAberth::iterate(const double* op, int N, double* zeror, double* zeroi) {
+  start(N);
+  active.resize(N);
+  w.resize(N);
+  for (int i = 0; i < N; i++)   active[i] = i;
+
+  for (sweeps = 0; sweeps < maxIter && !active.empty(); sweeps++){
+    cauchy.build(N, z);
+
+    corrections(op, N);
+
+    int n = active.size();
+    int m = 0;
+    for (int k = 0; k < n; k++){
+      int i = active[k];
+      z[i] -= w[k];
+      if (std::abs(w[k]) <= 2.0*DBL_EPSILON*std::abs(z[i]) + atol + rtol*std::abs(z[i])){
+        done[i] = true;
+      }
+      else {
+        active[m++] = i;
+      }
+    }
+    active.resize(m);
+  }
+
+  realify(N, zeror, zeroi);
+  return ((!active.empty()) ? converged(N, zeror, zeroi) : N);
+}
+
+#endif
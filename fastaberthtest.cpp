@@ -0,0 +1,167 @@
+#include "gmock/gmock.h"
+
+#include "rpoly.h"
+#include "fastaberth.h"
+#include "cauchy.h"
+#include "mapped.h"
+#include "roots.h"
+#include "helper.h"
+
+#include <vector>
+#include <complex>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <algorithm>
+#include <unistd.h>
+
+using namespace testing;
+
+class UltraHighDegree: public Test {
+  public:
+    // |p(z)| relative to sum |C(N-e)| |z|^e, reversed in 1/z outside the unit disk
+    double residual(const std::vector<double>& op, std::complex<double> z) {
+      int N = op.size() - 1;
+      std::complex<long double> x(z.real(), z.imag()), p;
+      long double ax = std::abs(x), b;
+      if(ax <= 1.0) {
+        p = op[0];
+        b = fabs(op[0]);
+        for(int i=1; i<=N; i++) {
+          p = p*x + (long double)op[i];
+          b = b*ax + fabs(op[i]);
+        }
+      }
+      else {
+        x = 1.0L/x;
+        ax = 1.0L/ax;
+        p = op[N];
+        b = fabs(op[N]);
+        for(int i=N-1; i>=0; i--) {
+          p = p*x + (long double)op[i];
+          b = b*ax + fabs(op[i]);
+        }
+      }
+      return std::abs(p)/b;
+    }
+};
+
+TEST_F(UltraHighDegree, CauchySumMatchesDirectSum) {
+  int n = 2000;
+  std::vector<std::complex<double> > z(n), s(n);
+  srand(7);
+  for(int j=0; j<n; j++) z[j] = std::complex<double>(rand()/(double)RAND_MAX - 0.5, rand()/(double)RAND_MAX - 0.5);
+
+  CauchySum cauchy(30, 0.4);
+  cauchy.evaluate(n, z.data(), s.data());
+  for(int i=0; i<n; i+=97) {
+    std::complex<double> direct = 0.0;
+    for(int j=0; j<n; j++) {
+      if(j != i) direct += 1.0/(z[i] - z[j]);
+    }
+    EXPECT_THAT(std::abs(s[i] - direct), Le(1e-11*std::abs(direct)));
+  }
+}
+
+TEST_F(UltraHighDegree, AgreesWithAkitiOnSmallDegree) {
+  FastAberth fast(10);
+  Roots rootfinder(&fast);
+  // (x-1)(x-2)(x-3)(x^2+1)
+  std::vector<double> coeff = {1, -6, 12, -12, 11, -6};
+  rootfinder.findRoots(coeff);
+
+  int nRealRoot;
+  std::vector<double> real;
+  rootfinder.getRoots(nRealRoot, real);
+  real.resize(nRealRoot);
+  std::sort(real.begin(), real.end());
+  ASSERT_THAT(nRealRoot, Eq(3));
+  for(int j=0; j<3; j++) {
+    EXPECT_THAT(real[j], DoubleNear(j + 1.0, 1e-12));
+  }
+}
+
+TEST_F(UltraHighDegree, RootsOfUnity) {
+  int N = 3000;
+  FastAberth fast(N);
+  std::vector<double> op(N + 1, 0.0), zr(N), zi(N);
+  op[0] = 1.0;
+  op[N] = -1.0;
+
+  int found;
+  EXPECT_TRUE(fast.solve(op.data(), N, zr.data(), zi.data(), &found) == RootStatus::Success);
+  EXPECT_THAT(found, Eq(N));
+  for(int j=0; j<N; j++) {
+    EXPECT_THAT(std::hypot(zr[j], zi[j]), DoubleNear(1.0, 1e-13));
+  }
+}
+
+// Above degree 5000 most corrections come from FFTs on circles
+TEST_F(UltraHighDegree, RandomPolynomialResidualsAtRoundingLevel) {
+  int N = 6000;
+  FastAberth fast(N);
+  std::vector<double> op(N + 1), zr(N), zi(N);
+  srand(11);
+  for(int j=0; j<=N; j++) op[j] = 2.0*rand()/(double)RAND_MAX - 1.0;
+
+  int found;
+  EXPECT_TRUE(fast.solve(op.data(), N, zr.data(), zi.data(), &found) == RootStatus::Success);
+  EXPECT_THAT(found, Eq(N));
+  EXPECT_THAT(fast.getSweepCount(), Lt(100));
+  for(int j=0; j<N; j++) {
+    EXPECT_THAT(residual(op, std::complex<double>(zr[j], zi[j])), Le(10.0*N*DBL_EPSILON));
+  }
+}
+
+TEST_F(UltraHighDegree, MappedCoefficientsMatchVector) {
+  char path[] = "/tmp/mappedpolyXXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_THAT(fd, Ge(0));
+  // (x-1)(x-2)(x-3)
+  double coeff[] = {1, -6, 11, -6};
+  ASSERT_THAT(write(fd, coeff, sizeof(coeff)), Eq((ssize_t)sizeof(coeff)));
+  close(fd);
+
+  FastAberth fast(10);
+  Roots rootfinder(&fast);
+  {
+    MappedPoly poly(path);
+    EXPECT_THAT(poly.degree(), Eq(3));
+    EXPECT_THAT(poly.coefficient(2), Eq(11.0));
+    rootfinder.findRoots(poly);
+  }
+  unlink(path);
+
+  EXPECT_THAT(rootfinder.getMinPosRealRoot(), DoubleNear(1.0, 1e-13));
+  EXPECT_THAT(rootfinder.getMaxPosRealRoot(), DoubleNear(3.0, 1e-13));
+}
+
+// The work of the sums per point grows with log n: sixteen times the points cost far less
+// than sixteen times the work per point, which the direct sum would take
+TEST_F(UltraHighDegree, CauchySumWorkPerPointGrowsLogarithmically) {
+  double perPoint[2];
+  int sizes[2] = {1000, 16000};
+  for(int d=0; d<2; d++) {
+    int n = sizes[d];
+    std::vector<std::complex<double> > z(n), s(n);
+    srand(7);
+    for(int j=0; j<n; j++) z[j] = std::complex<double>(rand()/(double)RAND_MAX - 0.5, rand()/(double)RAND_MAX - 0.5);
+
+    CauchySum cauchy;
+    cauchy.evaluate(n, z.data(), s.data());
+    perPoint[d] = cauchy.getWork()/(double)n;
+  }
+  EXPECT_THAT(perPoint[1], Lt(4.0*perPoint[0]));
+  EXPECT_THAT(perPoint[1], Lt(sizes[1]/4.0));
+}
+
+TEST_F(UltraHighDegree, MissingCoefficientFile) {
+  try {
+    MappedPoly poly("/nonexistent/coefficients");
+    FAIL() << "Expected std::runtime_error";
+  }
+  catch (const std::runtime_error& expected) {
+    ASSERT_STREQ(expected.what(), "Cannot open coefficient file /nonexistent/coefficients.");
+  }
+}
@@ -0,0 +1,85 @@
+#include "fastaberth.h"
+#include "mapped.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <cstdio>
+#include <stdexcept>
+#include <unistd.h>
+
+// Benchmark of FastAberth on polynomials of very high degree read from mapped files:
+//
+//   fastbench [degree ...]
+//
+// For each degree, 10^4 and 10^5 by default, writes random coefficients in [-1, 1] to a
+// temporary file, maps it and times the solve. Prints the time, the sweeps and the time
+// relative to the first degree next to the ratio N log N and N^2 would give.
+
+int main(int argc, char** argv) {
+  std::vector<int> degrees;
+  for(int a=1; a<argc; a++) degrees.push_back(std::atoi(argv[a]));
+  if(degrees.empty())   degrees = {10000, 100000};
+  for(int N : degrees) {
+    if(N < 1) {
+      std::cerr << "usage: " << argv[0] << " [degree ...]" << std::endl;
+      return 2;
+    }
+  }
+
+  typedef std::chrono::steady_clock Clock;
+  double first{0.0};
+  for(size_t d=0; d<degrees.size(); d++) {
+    int N = degrees[d];
+    std::mt19937 generator(13);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::vector<double> op(N + 1);
+    for(int j=0; j<=N; j++) op[j] = uniform(generator);
+
+    char path[] = "/tmp/fastbenchXXXXXX";
+    int fd = mkstemp(path);
+    if(fd < 0 || write(fd, op.data(), (N + 1)*sizeof(double)) != (ssize_t)((N + 1)*sizeof(double))) {
+      std::cerr << "Cannot write the coefficient file " << path << "." << std::endl;
+      if(fd >= 0) {
+        close(fd);
+        unlink(path);
+      }
+      return 1;
+    }
+    close(fd);
+
+    try {
+      FastAberth fast(N);
+      std::vector<double> zr(N), zi(N);
+      int found;
+      RootStatus status;
+      double seconds;
+      {
+        MappedPoly poly(path);
+        Clock::time_point start = Clock::now();
+        status = fast.solve(poly.data(), N, zr.data(), zi.data(), &found);
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+      }
+      unlink(path);
+
+      if(d == 0)   first = seconds;
+      double r = (double)N/degrees[0];
+      std::cout << "degree " << N << ": " << seconds << " s, " << fast.getSweepCount() << " sweeps, "
+                << found << " roots" << ((status == RootStatus::Success) ? "" : " (not converged)");
+      if(d > 0) {
+        std::cout << ", " << seconds/first << " times degree " << degrees[0]
+                  << " (N log N " << r*log((double)N)/log((double)degrees[0]) << ", N^2 " << r*r << ")";
+      }
+      std::cout << std::endl;
+    }
+    catch (const std::exception& e) {
+      unlink(path);
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include <vector>
+#include <complex>
+#include <cmath>
+
+#ifndef FFT_h
+#define FFT_h
+
+// Radix-2 fast Fourier transform. transform replaces a, of length M a power of two, by
+//
+//   A_k = sum_(j < M) a_j w^(jk),   w = exp(sign 2 pi i/M)
+//
+// without normalization. The twiddle factors are computed directly, not by recurrence,
+// so the rounding error stays O(log M) eps.
+
+class FFT {
+  public:
+    void transform(std::vector<std::complex<double> >& a, int sign);
+
+  private:
+    std::vector<std::complex<double> > twiddle;
+    int size{0};
+    int direction{0};
+};
+
+inline void FFT::transform(std::vector<std::complex<double> >& a, int sign) {
+  const double pi = 3.14159265358979323846;
+  int M = a.size();
+
+  if(M != size || sign != direction) {
+    twiddle.resize(M/2);
+    for(int k=0; k<M/2; k++) twiddle[k] = std::polar(1.0, sign*2.0*pi*k/M);
+    size = M;
+    direction = sign;
+  }
+
+  // Bit reversal permutation
+  for(int i=1, j=0; i<M; i++) {
+    int bit = M >> 1;
+    for(; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if(i < j) std::swap(a[i], a[j]);
+  }
+
+  for(int len=2; len<=M; len <<= 1) {
+    int half = len/2, step = M/len;
+    for(int i=0; i<M; i+=len) {
+      for(int k=0; k<half; k++) {
+        std::complex<double> t = twiddle[k*step]*a[i + k + half];
+        a[i + k + half] = a[i + k] - t;
+        a[i + k] += t;
+      }
+    }
+  }
+}
+
+#endif
@@ -1,4 +1,7 @@
 #include <limits>
+#include <cmath>
+
+#include "kernels.h"
 
 #ifndef Helper_h
 #define Helper_h
@@ -7,6 +10,7 @@ class Helper {
   public:
     bool nearly_equal(double a, double b) const;
     bool nearly_equal(double a, double b, int factor) const;
+    bool nearly_real(double zr, double zi, double rtol, double atol) const;
     double absmin(int dim, double* x) const;
     double minpos(int dim, double* x) const;
     double maxpos(int dim, double* x) const;
@@ -14,94 +18,80 @@ class Helper {
     double maxneg(int dim, double* x) const;
 };
 
-bool Helper::nearly_equal(double a, double b) const {
+inline bool Helper::nearly_equal(double a, double b) const {
   return std::nextafter(a, std::numeric_limits<double>::lowest()) <= b
       && std::nextafter(a, std::numeric_limits<double>::max()) >= b;
 }
 
-bool Helper::nearly_equal(double a, double b, int factor /* a factor of epsilon */) const {
+inline bool Helper::nearly_equal(double a, double b, int factor /* a factor of epsilon */) const {
   double min_a = a - (a - std::nextafter(a, std::numeric_limits<double>::lowest())) * factor;
   double max_a = a + (std::nextafter(a, std::numeric_limits<double>::max()) - a) * factor;
 
   return min_a <= b && max_a >= b;
 }
 
+// Classification of a computed root as real. Without a tolerance the imaginary part
+// must vanish to within 10 ulps, otherwise it must be within atol + rtol*|z|.
+inline bool Helper::nearly_real(double zr, double zi, double rtol, double atol) const {
+  if(rtol == 0.0 && atol == 0.0) return nearly_equal(zi, 0.0, 10);
+  return std::fabs(zi) <= atol + rtol*std::hypot(zr, zi);
+}
+
 // Code duplication should be eliminated!
 
-double Helper::absmin(int dim, double* x) const {
-  double minimum,tmp;
+inline double Helper::absmin(int dim, double* x) const {
+  double minimum;
 
   minimum = x[0];
-  for(int j=1;j<dim;j++) {
-    tmp = x[j];
-    if(tmp < 0.0) tmp = -tmp;
-    minimum = std::min(minimum,tmp);
-  }
-  return minimum;
+  return Kernels::active().minimum(1, dim, x, 0, minimum);
 }
 
-double Helper::minpos(int dim, double* x) const {
+inline double Helper::minpos(int dim, double* x) const {
   int k{0};
-  double minimum,tmp;
+  double minimum;
 
   do {
     // std::cout << "k = " << k << std::endl;
     minimum = x[k++];
   } while( minimum < 0.0 && k<dim );
   // std::cout << "k = " << k << std::endl;
-  for(int j=k;j<dim;j++) {
-    tmp = x[j];
-    if(tmp > 0.0 && tmp < minimum) minimum = tmp;
-  }
-  return minimum;
+  return Kernels::active().minimum(k, dim, x, 1, minimum);
 }
 
-double Helper::maxpos(int dim, double* x) const {
+inline double Helper::maxpos(int dim, double* x) const {
   int k{0};
-  double maximum,tmp;
+  double maximum;
 
   do {
     // std::cout << "k = " << k << std::endl;
     maximum = x[k++];
   } while( maximum < 0.0 && k<dim );
   // std::cout << "k = " << k << std::endl;
-  for(int j=k;j<dim;j++) {
-    tmp = x[j];
-    if(tmp > 0.0 && tmp > maximum) maximum = tmp;
-  }
-  return maximum;
+  return Kernels::active().maximum(k, dim, x, 1, maximum);
 }
 
-double Helper::minneg(int dim, double* x) const {
+inline double Helper::minneg(int dim, double* x) const {
   int k{0};
-  double minimum,tmp;
+  double minimum;
 
   do {
     // std::cout << "k = " << k << std::endl;
     minimum = x[k++];
   } while( minimum > 0.0 && k<dim );
   // std::cout << "k = " << k << std::endl;
-  for(int j=k;j<dim;j++) {
-    tmp = x[j];
-    if(tmp < 0.0 && tmp > minimum) minimum = tmp;
-  }
-  return minimum;
+  return Kernels::active().maximum(k, dim, x, -1, minimum);
 }
 
-double Helper::maxneg(int dim, double* x) const {
+inline double Helper::maxneg(int dim, double* x) const {
   int k{0};
-  double maximum,tmp;
+  double maximum;
 
   do {
     // std::cout << "k = " << k << std::endl;
     maximum = x[k++];
   } while( maximum > 0.0 && k<dim );
   // std::cout << "k = " << k << std::endl;
-  for(int j=k;j<dim;j++) {
-    tmp = x[j];
-    if(tmp < 0.0 && tmp < maximum) maximum = tmp;
-  }
-  return maximum;
+  return Kernels::active().minimum(k, dim, x, -1, maximum);
 }
 
 #endif
@@ -0,0 +1,318 @@
+#include <cmath>
+#include <cstring>
+#include <atomic>
+#include <stdexcept>
+
+#ifndef Kernels_h
+#define Kernels_h
+
+// The inner loops of the Jenkins-Traub iteration and of the scans of Helper, in one version
+// per x86 vector extension, chosen at run time.
+//
+// The build has no -march, so that one binary runs on every x86-64 machine; each version
+// here is compiled for its own instruction set with the target attribute instead, and
+// active() takes the widest one the processor supports, from cpuid, the first time it is
+// asked. The elementwise loops, the updates of the K polynomial and the scans for extreme
+// roots, work on 2, 4 or 8 doubles at a time as SIMD vectors. The recurrences, Horner's
+// rule and the synthetic division by a quadratic, depend on the previous step at every
+// step and stay scalar in every version, in the encoding of its instruction set.
+//
+// Every version computes each element with the same operations in the same order, and
+// contraction into fused multiply-adds, which AVX-512 would otherwise allow, is turned off
+// here, so all versions give the same roots to the last bit. select() forces a version,
+// for the tests and to rule the vector code out when chasing a problem; other than that
+// the choice is made once and kept.
+
+enum class KernelPath {
+  Generic,
+  SSE2,
+  AVX2,
+  AVX512
+};
+
+class Kernels {
+  public:
+    static const Kernels& active(void);
+    static const Kernels& get(KernelPath path);
+    static void select(KernelPath path);
+    static bool supported(KernelPath path);
+    static KernelPath best(void);
+
+    KernelPath getPath(void) const;
+
+    // q[0..n-1] the partial sums of Horner's rule for p at s; returns p(s)
+    double horner(int n, const double* p, double s, double* q) const;
+    // p(s) alone
+    double value(int n, const double* p, double s) const;
+    // Rounding error bound e*m^(n-1) + sum |q[i]| m^(n-1-i) over i >= 1
+    double bound(int n, const double* q, double m, double e) const;
+    // Division of p by 1, u, v: quotient in q, remainder in a, b
+    void quadSD(int n, double u, double v, const double* p, double* q, double* a, double* b) const;
+    // K[i] = -(a7*qp[i-1]) + a3*qk[i-2] (+ qp[i] if withP) for 2 <= i < n
+    void nextK(int n, double a7, double a3, const double* qk, const double* qp, bool withP, double* K) const;
+    // K[i] = t*qk[i-1] + qp[i] for 1 <= i < n
+    void realK(int n, double t, const double* qk, const double* qp, double* K) const;
+    // The smallest (largest) of m and the x[j], k <= j < n, that are positive (sign 1) or
+    // negative (sign -1); for sign 0 the smallest of m and all |x[j]|
+    double minimum(int k, int n, const double* x, int sign, double m) const;
+    double maximum(int k, int n, const double* x, int sign, double m) const;
+
+  private:
+    KernelPath path;
+    double (*horner_)(int, const double*, double, double*);
+    double (*value_)(int, const double*, double);
+    double (*bound_)(int, const double*, double, double);
+    void (*quadSD_)(int, double, double, const double*, double*, double*, double*);
+    void (*nextK_)(int, double, double, const double*, const double*, bool, double*);
+    void (*realK_)(int, double, const double*, const double*, double*);
+    double (*minimum_)(int, int, const double*, int, double);
+    double (*maximum_)(int, int, const double*, int, double);
+
+    template<int W> static Kernels make(KernelPath path);
+    static std::atomic<const Kernels*>& current(void);
+};
+
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+
+// The loops, on vectors of W doubles, plain doubles for W = 1; inlined into the version of
+// each instruction set
+template<int W> struct KernelLoops {
+  typedef double V __attribute__((vector_size(W*sizeof(double))));
+
+  static inline __attribute__((always_inline)) double horner(int n, const double* p, double s, double* q) {
+    double pv = q[0] = p[0];
+    for(int i=1; i<n; i++) q[i] = pv = pv*s + p[i];
+    return pv;
+  }
+
+  static inline __attribute__((always_inline)) double value(int n, const double* p, double s) {
+    double pv = p[0];
+    for(int i=1; i<n; i++) pv = pv*s + p[i];
+    return pv;
+  }
+
+  static inline __attribute__((always_inline)) double bound(int n, const double* q, double m, double e) {
+    for(int i=1; i<n; i++) e = e*m + std::fabs(q[i]);
+    return e;
+  }
+
+  static inline __attribute__((always_inline)) void quadSD(int n, double u, double v, const double* p, double* q,
+                                                           double* a, double* b) {
+    double bb = q[0] = p[0];
+    double aa = q[1] = -(bb*u) + p[1];
+    for(int i=2; i<n; i++) {
+      q[i] = -(aa*u + bb*v) + p[i];
+      bb = aa;
+      aa = q[i];
+    }
+    *a = aa;
+    *b = bb;
+  }
+
+  static inline __attribute__((always_inline)) void nextK(int n, double a7, double a3, const double* __restrict qk,
+                                                          const double* __restrict qp, bool withP, double* __restrict K) {
+    int i = 2;
+    V x, y, z;
+    for(; i+W<=n; i+=W) {
+      std::memcpy(&x, qp + i - 1, sizeof(V));
+      std::memcpy(&y, qk + i - 2, sizeof(V));
+      z = -(a7*x) + a3*y;
+      if(withP) {
+        std::memcpy(&x, qp + i, sizeof(V));
+        z = z + x;
+      }
+      std::memcpy(K + i, &z, sizeof(V));
+    }
+    for(; i<n; i++) K[i] = (withP ? -(a7*qp[i - 1]) + a3*qk[i - 2] + qp[i] : -(a7*qp[i - 1]) + a3*qk[i - 2]);
+  }
+
+  static inline __attribute__((always_inline)) void realK(int n, double t, const double* __restrict qk,
+                                                          const double* __restrict qp, double* __restrict K) {
+    int i = 1;
+    V x, y;
+    for(; i+W<=n; i+=W) {
+      std::memcpy(&x, qk + i - 1, sizeof(V));
+      std::memcpy(&y, qp + i, sizeof(V));
+      x = t*x + y;
+      std::memcpy(K + i, &x, sizeof(V));
+    }
+    for(; i<n; i++) K[i] = t*qk[i - 1] + qp[i];
+  }
+
+  // Lanes keep their own extreme, of the values that qualify, and +-infinity until one does
+  template<bool Max> static inline __attribute__((always_inline)) double extreme(int k, int n, const double* x,
+                                                                                 int sign, double m) {
+    const V zero = V() + 0.0;
+    const V none = V() + (Max ? -HUGE_VAL : HUGE_VAL);
+    V e = none, y;
+    int j = k;
+    for(; j+W<=n; j+=W) {
+      std::memcpy(&y, x + j, sizeof(V));
+      if(sign == 0) y = ((y < zero) ? -y : y);
+      else y = (((sign > 0) ? (y > zero) : (y < zero)) ? y : none);
+      e = ((Max ? (y > e) : (y < e)) ? y : e);
+    }
+    double lane[W];
+    std::memcpy(lane, &e, sizeof(V));
+    for(int l=0; l<W; l++) {
+      if(Max ? (lane[l] > m) : (lane[l] < m)) m = lane[l];
+    }
+    for(; j<n; j++) {
+      double t = x[j];
+      if(sign == 0) t = ((t < 0.0) ? -t : t);
+      else if(!((sign > 0) ? (t > 0.0) : (t < 0.0))) continue;
+      if(Max ? (t > m) : (t < m)) m = t;
+    }
+    return m;
+  }
+};
+
+// One function per kernel and instruction set, each compiled for that set
+#define KERNEL_VERSIONS(Name, Target, W)                                                                    \
+  Target inline double Name##Horner(int n, const double* p, double s, double* q) {                         \
+    return KernelLoops<W>::horner(n, p, s, q);                                                             \
+  }                                                                                                         \
+  Target inline double Name##Value(int n, const double* p, double s) {                                     \
+    return KernelLoops<W>::value(n, p, s);                                                                 \
+  }                                                                                                         \
+  Target inline double Name##Bound(int n, const double* q, double m, double e) {                           \
+    return KernelLoops<W>::bound(n, q, m, e);                                                              \
+  }                                                                                                         \
+  Target inline void Name##QuadSD(int n, double u, double v, const double* p, double* q, double* a, double* b) { \
+    KernelLoops<W>::quadSD(n, u, v, p, q, a, b);                                                           \
+  }                                                                                                         \
+  Target inline void Name##NextK(int n, double a7, double a3, const double* qk, const double* qp, bool withP, \
+                                 double* K) {                                                               \
+    KernelLoops<W>::nextK(n, a7, a3, qk, qp, withP, K);                                                    \
+  }                                                                                                         \
+  Target inline void Name##RealK(int n, double t, const double* qk, const double* qp, double* K) {         \
+    KernelLoops<W>::realK(n, t, qk, qp, K);                                                                \
+  }                                                                                                         \
+  Target inline double Name##Minimum(int k, int n, const double* x, int sign, double m) {                  \
+    return KernelLoops<W>::template extreme<false>(k, n, x, sign, m);                                      \
+  }                                                                                                         \
+  Target inline double Name##Maximum(int k, int n, const double* x, int sign, double m) {                  \
+    return KernelLoops<W>::template extreme<true>(k, n, x, sign, m);                                       \
+  }
+
+namespace kernels {
+KERNEL_VERSIONS(generic, __attribute__(()), 1)
+#if defined(__x86_64__) || defined(__i386__)
+KERNEL_VERSIONS(sse2, __attribute__((target("sse2"))), 2)
+KERNEL_VERSIONS(avx2, __attribute__((target("avx2"))), 4)
+KERNEL_VERSIONS(avx512, __attribute__((target("avx512f"))), 8)
+#endif
+}
+
+#undef KERNEL_VERSIONS
+
+#pragma GCC pop_options
+
+#define KERNEL_TABLE(k, Name)                                                                               \
+  k.horner_ = kernels::Name##Horner;                                                                        \
+  k.value_ = kernels::Name##Value;                                                                          \
+  k.bound_ = kernels::Name##Bound;                                                                          \
+  k.quadSD_ = kernels::Name##QuadSD;                                                                        \
+  k.nextK_ = kernels::Name##NextK;                                                                          \
+  k.realK_ = kernels::Name##RealK;                                                                          \
+  k.minimum_ = kernels::Name##Minimum;                                                                      \
+  k.maximum_ = kernels::Name##Maximum;
+
+template<int W> inline Kernels Kernels::make(KernelPath path) {
+  Kernels k;
+  k.path = path;
+  switch(W) {
+#if defined(__x86_64__) || defined(__i386__)
+    case 2:  KERNEL_TABLE(k, sse2) break;
+    case 4:  KERNEL_TABLE(k, avx2) break;
+    case 8:  KERNEL_TABLE(k, avx512) break;
+#endif
+    default: KERNEL_TABLE(k, generic) break;
+  }
+  return k;
+}
+
+#undef KERNEL_TABLE
+
+inline bool Kernels::supported(KernelPath path) {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  switch(path) {
+    case KernelPath::Generic: return true;
+    case KernelPath::SSE2:    return __builtin_cpu_supports("sse2");
+    case KernelPath::AVX2:    return __builtin_cpu_supports("avx2");
+    case KernelPath::AVX512:  return __builtin_cpu_supports("avx512f");
+  }
+  return false;
+#else
+  return (path == KernelPath::Generic);
+#endif
+}
+
+inline KernelPath Kernels::best(void) {
+  if(supported(KernelPath::AVX512)) return KernelPath::AVX512;
+  if(supported(KernelPath::AVX2))   return KernelPath::AVX2;
+  if(supported(KernelPath::SSE2))   return KernelPath::SSE2;
+  return KernelPath::Generic;
+}
+
+inline const Kernels& Kernels::get(KernelPath path) {
+  static const Kernels table[] = {make<1>(KernelPath::Generic), make<2>(KernelPath::SSE2),
+                                  make<4>(KernelPath::AVX2), make<8>(KernelPath::AVX512)};
+  if(!supported(path)) {
+    throw std::invalid_argument( "The processor does not support this kernel path." );
+  }
+  return table[(int)path];
+}
+
+inline std::atomic<const Kernels*>& Kernels::current(void) {
+  static std::atomic<const Kernels*> kernels{&get(best())};
+  return kernels;
+}
+
+inline const Kernels& Kernels::active(void) {
+  return *current().load(std::memory_order_relaxed);
+}
+
+inline void Kernels::select(KernelPath path) {
+  current().store(&get(path));
+}
+
+inline KernelPath Kernels::getPath(void) const {
+  return path;
+}
+
+inline double Kernels::horner(int n, const double* p, double s, double* q) const {
+  return horner_(n, p, s, q);
+}
+
+inline double Kernels::value(int n, const double* p, double s) const {
+  return value_(n, p, s);
+}
+
+inline double Kernels::bound(int n, const double* q, double m, double e) const {
+  return bound_(n, q, m, e);
+}
+
+inline void Kernels::quadSD(int n, double u, double v, const double* p, double* q, double* a, double* b) const {
+  quadSD_(n, u, v, p, q, a, b);
+}
+
+inline void Kernels::nextK(int n, double a7, double a3, const double* qk, const double* qp, bool withP, double* K) const {
+  nextK_(n, a7, a3, qk, qp, withP, K);
+}
+
+inline void Kernels::realK(int n, double t, const double* qk, const double* qp, double* K) const {
+  realK_(n, t, qk, qp, K);
+}
+
+inline double Kernels::minimum(int k, int n, const double* x, int sign, double m) const {
+  return minimum_(k, n, x, sign, m);
+}
+
+inline double Kernels::maximum(int k, int n, const double* x, int sign, double m) const {
+  return maximum_(k, n, x, sign, m);
+}
+
+#endif
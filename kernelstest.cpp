@@ -0,0 +1,121 @@
+#include "gmock/gmock.h"
+
+#include "kernels.h"
+#include "akiti.h"
+#include "helper.h"
+
+#include <vector>
+#include <random>
+#include <cstring>
+
+using namespace testing;
+
+// Every version the processor supports, against the generic one, which is not vectorized
+class KernelPaths: public Test {
+  public:
+    std::vector<KernelPath> paths;
+    std::mt19937 rng{7};
+
+    void SetUp() override {
+      KernelPath all[] = {KernelPath::SSE2, KernelPath::AVX2, KernelPath::AVX512};
+      for(KernelPath path : all) {
+        if(Kernels::supported(path)) paths.push_back(path);
+      }
+    }
+
+    void TearDown() override {
+      Kernels::select(Kernels::best());
+    }
+
+    std::vector<double> random(int n) {
+      std::uniform_real_distribution<double> u(-1.0, 1.0);
+      std::vector<double> x(n);
+      for(int j=0; j<n; j++) x[j] = u(rng);
+      return x;
+    }
+
+    bool same(const std::vector<double>& a, const std::vector<double>& b) {
+      return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size()*sizeof(double)) == 0;
+    }
+};
+
+TEST_F(KernelPaths, BestPathIsSupported) {
+  ASSERT_TRUE(Kernels::supported(KernelPath::Generic));
+  ASSERT_TRUE(Kernels::supported(Kernels::best()));
+  ASSERT_THAT(Kernels::active().getPath(), Eq(Kernels::best()));
+}
+
+TEST_F(KernelPaths, UpdatesOfKAreTheSameToTheLastBit) {
+  const Kernels& generic = Kernels::get(KernelPath::Generic);
+  for(KernelPath path : paths) {
+    const Kernels& kernels = Kernels::get(path);
+    // Lengths around every vector width, for the loops and their tails
+    for(int n=2; n<40; n++) {
+      std::vector<double> qk = random(n), qp = random(n), K0(n, 0.0), K1(n, 0.0);
+      generic.nextK(n, 0.3, -1.7, qk.data(), qp.data(), true, K0.data());
+      kernels.nextK(n, 0.3, -1.7, qk.data(), qp.data(), true, K1.data());
+      ASSERT_TRUE(same(K0, K1));
+      generic.nextK(n, 0.3, -1.7, qk.data(), qp.data(), false, K0.data());
+      kernels.nextK(n, 0.3, -1.7, qk.data(), qp.data(), false, K1.data());
+      ASSERT_TRUE(same(K0, K1));
+      generic.realK(n, 0.9, qk.data(), qp.data(), K0.data());
+      kernels.realK(n, 0.9, qk.data(), qp.data(), K1.data());
+      ASSERT_TRUE(same(K0, K1));
+    }
+  }
+}
+
+TEST_F(KernelPaths, RecurrencesAreTheSameToTheLastBit) {
+  const Kernels& generic = Kernels::get(KernelPath::Generic);
+  std::vector<double> p = random(30), q0(30), q1(30);
+  for(KernelPath path : paths) {
+    const Kernels& kernels = Kernels::get(path);
+    ASSERT_THAT(kernels.horner(30, p.data(), 0.7, q1.data()), Eq(generic.horner(30, p.data(), 0.7, q0.data())));
+    ASSERT_TRUE(same(q0, q1));
+    ASSERT_THAT(kernels.value(30, p.data(), -1.1), Eq(generic.value(30, p.data(), -1.1)));
+    ASSERT_THAT(kernels.bound(30, p.data(), 0.8, 0.5), Eq(generic.bound(30, p.data(), 0.8, 0.5)));
+    double a0, b0, a1, b1;
+    generic.quadSD(30, 0.4, 1.3, p.data(), q0.data(), &a0, &b0);
+    kernels.quadSD(30, 0.4, 1.3, p.data(), q1.data(), &a1, &b1);
+    ASSERT_TRUE(same(q0, q1));
+    ASSERT_THAT(a1, Eq(a0));
+    ASSERT_THAT(b1, Eq(b0));
+  }
+}
+
+TEST_F(KernelPaths, ScansOfHelperFindTheExtremes) {
+  Helper helper;
+  std::vector<double> x = {0.5, -3.0, 2.0, -0.25, 7.0, -8.0, 0.125, 1.0, -1.0, 3.0, -0.5, 6.0, -2.0};
+  paths.push_back(KernelPath::Generic);
+  for(KernelPath path : paths) {
+    Kernels::select(path);
+    ASSERT_THAT(helper.absmin(x.size(), x.data()), Eq(0.125));
+    ASSERT_THAT(helper.minpos(x.size(), x.data()), Eq(0.125));
+    ASSERT_THAT(helper.maxpos(x.size(), x.data()), Eq(7.0));
+    ASSERT_THAT(helper.minneg(x.size(), x.data()), Eq(-0.25));
+    ASSERT_THAT(helper.maxneg(x.size(), x.data()), Eq(-8.0));
+  }
+}
+
+TEST_F(KernelPaths, SolverFindsTheSameRootsOnEveryPath) {
+  int N = 60;
+  std::vector<double> op = random(N + 1);
+  std::vector<double> zr0(N), zi0(N);
+  int found0;
+  Kernels::select(KernelPath::Generic);
+  {
+    Akiti akiti(N);
+    std::vector<double> c(op);
+    ASSERT_THAT(akiti.solve(c.data(), N, zr0.data(), zi0.data(), &found0), Eq(RootStatus::Success));
+  }
+  for(KernelPath path : paths) {
+    Kernels::select(path);
+    Akiti akiti(N);
+    std::vector<double> c(op), zr(N), zi(N);
+    int found;
+    ASSERT_THAT(akiti.solve(c.data(), N, zr.data(), zi.data(), &found), Eq(RootStatus::Success));
+    ASSERT_THAT(found, Eq(found0));
+    ASSERT_TRUE(same(zr, zr0));
+    ASSERT_TRUE(same(zi, zi0));
+  }
+}
@@ -0,0 +1,78 @@
+#include <string>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifndef MappedPoly_h
+#define MappedPoly_h
+
+// Coefficients of a polynomial of very high degree read from a file by mapping it into
+// memory. The file holds the N+1 coefficients as raw doubles in native byte order, the
+// leading coefficient first. The pages are only read as a solver touches them and are
+// never copied into a std::vector.
+//
+// The mapping is private: op may be written through data(), as RPoly::rpoly allows,
+// without changing the file.
+
+class MappedPoly {
+  public:
+    MappedPoly(const std::string& path);
+    ~MappedPoly(void);
+    MappedPoly(const MappedPoly&) = delete;
+    MappedPoly& operator=(const MappedPoly&) = delete;
+
+    int degree(void) const;
+    double* data(void) const;
+    double coefficient(int j) const;
+
+  private:
+    double* op{nullptr};
+    size_t bytes{0};
+    int N{0};
+};
+
+inline MappedPoly::MappedPoly(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if(fd < 0) {
+    throw std::runtime_error( "Cannot open coefficient file " + path + "." );
+  }
+
+  struct stat st;
+  if(fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(double) || st.st_size % sizeof(double) != 0) {
+    close(fd);
+    throw std::invalid_argument( "Coefficient file " + path + " does not hold a whole number of doubles." );
+  }
+  bytes = st.st_size;
+
+  void* addr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(addr == MAP_FAILED) {
+    throw std::runtime_error( "Cannot map coefficient file " + path + "." );
+  }
+  madvise(addr, bytes, MADV_SEQUENTIAL);
+
+  op = static_cast<double*>(addr);
+  N  = bytes/sizeof(double) - 1;
+}
+
+inline MappedPoly::~MappedPoly(void) {
+  if(op != nullptr) munmap(op, bytes);
+  op = nullptr;
+}
+
+inline int MappedPoly::degree(void) const {
+  return N;
+}
+
+inline double* MappedPoly::data(void) const {
+  return op;
+}
+
+inline double MappedPoly::coefficient(int j) const {
+  return op[j];
+}
+
+#endif
@@ -0,0 +1,193 @@
+#include <vector>
+#include <cmath>
+#include <climits>
+#include <algorithm>
+
+#include "sparse.h"
+
+#ifndef RootModuli_h
+#define RootModuli_h
+
+// Estimates of the moduli of all N roots, without computing the roots.
+//
+// The Newton polygon is the upper convex hull of the points (e, log|a_e|) of the terms
+// a_e x^e. An edge from exponent e to exponent e' stands for e' - e roots of modulus
+// about |a_e/a_e'|^(1/(e' - e)), and these estimates are within a factor of about 2N of
+// the true moduli. Each Graeffe root-squaring step before taking the polygon squares the
+// roots, which takes the square root of that factor: after three steps it is about
+// (2N)^(1/8), less than 2.5 for N up to 10^4.
+//
+// lowerBound is a bound below all moduli rather than an estimate: the positive root of
+// Cauchy's polynomial |a_N| x^N + ... + |a_1| x - |a_0|, taken after the Graeffe steps so
+// that it is within a factor of about N^(1/2^k) of the smallest modulus.
+//
+// The Graeffe steps square the range of the coefficients too, so they are taken with a
+// separate binary exponent for each coefficient, and cost O(N^2) each. Above maxDegree
+// only the polygon is used.
+
+class RootModuli {
+  public:
+    RootModuli(int steps = 3, int maxDegree = 2000);
+    void estimate(const double* op, int N, std::vector<double>& radius) const;
+    void estimate(const SparsePoly& poly, std::vector<double>& radius) const;
+    double lowerBound(const double* op, int N) const;
+
+  private:
+    int steps;
+    int maxDegree;
+
+    void polygon(int n, const int* e, const double* l, int N, double scale, std::vector<double>& radius) const;
+    void graeffe(std::vector<double>& m, std::vector<int>& s) const;
+    int squared(const double* op, int N, std::vector<double>& m, std::vector<int>& s) const;
+};
+
+inline RootModuli::RootModuli(int steps, int maxDegree) : steps(steps), maxDegree(maxDegree) {}
+
+// Radii from the polygon of the n points (e[j], l[j]) in order of increasing exponent, for
+// a polynomial of degree N whose roots are the 2^k-th powers of the roots wanted, with
+// scale = 2^-k. The radii are stored in increasing order, zeros at the origin first.
+inline void RootModuli::polygon(int n, const int* e, const double* l, int N, double scale, std::vector<double>& radius) const {
+  radius.assign(N, 0.0);
+  if(n == 0) return;
+
+  // Upper hull by the monotone chain
+  std::vector<int> hull;
+  for(int j=0; j<n; j++) {
+    while(hull.size() >= 2) {
+      int a = hull[hull.size() - 2], b = hull.back();
+      // Drop b if it lies on or below the chord from a to j
+      if((l[b] - l[a])*(e[j] - e[a]) <= (l[j] - l[a])*(e[b] - e[a])) hull.pop_back();
+      else break;
+    }
+    hull.push_back(j);
+  }
+
+  int k = e[0];
+  for(size_t h=1; h<hull.size(); h++) {
+    int a = hull[h - 1], b = hull[h];
+    double r = exp(scale*(l[a] - l[b])/(e[b] - e[a]));
+    for(; k<e[b]; k++) radius[k] = r;
+  }
+}
+
+// One root-squaring step on the coefficients m[i]*2^s[i] of x^i: the coefficient of y^k
+// in (-1)^N p(x)p(-x), y = x^2, is (-1)^(N+k) (a_k^2 + 2 sum_(j >= 1) (-1)^j a_(k-j) a_(k+j)).
+// The sign does not matter for the moduli and is dropped.
+inline void RootModuli::graeffe(std::vector<double>& m, std::vector<int>& s) const {
+  int N = m.size() - 1;
+  std::vector<double> qm(N + 1);
+  std::vector<int> qs(N + 1);
+
+  for(int k=0; k<=N; k++) {
+    int J = std::min(k, N - k);
+    // Largest exponent among the products, so that the sum neither overflows nor loses them
+    int top = INT_MIN;
+    if(m[k] != 0.0) top = 2*s[k];
+    for(int j=1; j<=J; j++) {
+      if(m[k - j] != 0.0 && m[k + j] != 0.0) top = std::max(top, s[k - j] + s[k + j] + 1);
+    }
+    if(top == INT_MIN) {
+      qm[k] = 0.0;
+      qs[k] = 0;
+      continue;
+    }
+
+    double sum = ((m[k] != 0.0) ? ldexp(m[k]*m[k], 2*s[k] - top) : 0.0);
+    for(int j=1; j<=J; j++) {
+      if(m[k - j] == 0.0 || m[k + j] == 0.0) continue;
+      double t = ldexp(m[k - j]*m[k + j], s[k - j] + s[k + j] + 1 - top);
+      sum += ((j & 1) ? -t : t);
+    }
+    int x;
+    qm[k] = frexp(sum, &x);
+    qs[k] = top + x;
+  }
+  m.swap(qm);
+  s.swap(qs);
+}
+
+// The coefficients of x^i as m[i]*2^s[i] after the Graeffe steps; returns their number
+inline int RootModuli::squared(const double* op, int N, std::vector<double>& m, std::vector<int>& s) const {
+  m.resize(N + 1);
+  s.resize(N + 1);
+  for(int i=0; i<=N; i++) {
+    m[i] = frexp(op[N - i], &s[i]);
+  }
+
+  int k = ((N <= maxDegree) ? steps : 0);
+  for(int step=0; step<k; step++) graeffe(m, s);
+  return k;
+}
+
+// Moduli of the roots of C(0)*X^N + ... + C(N), in increasing order
+inline void RootModuli::estimate(const double* op, int N, std::vector<double>& radius) const {
+  std::vector<double> m;
+  std::vector<int> s;
+  int k = squared(op, N, m, s);
+
+  std::vector<int> e;
+  std::vector<double> l;
+  for(int i=0; i<=N; i++) {
+    if(m[i] == 0.0) continue;
+    e.push_back(i);
+    l.push_back(log(fabs(m[i])) + s[i]*log(2.0));
+  }
+  polygon(e.size(), e.data(), l.data(), N, ldexp(1.0, -k), radius);
+}
+
+// No root of C(0)*X^N + ... + C(N) has a smaller modulus
+inline double RootModuli::lowerBound(const double* op, int N) const {
+  if(N < 1) return HUGE_VAL;
+  std::vector<double> m;
+  std::vector<int> s;
+  int k = squared(op, N, m, s);
+  if(m[0] == 0.0) return 0.0;
+
+  // log of the coefficients; Cauchy's polynomial is increasing in log x = t, so its root is
+  // found by bisection on t, with the sum taken relative to its largest term
+  std::vector<double> l(N + 1);
+  for(int i=0; i<=N; i++) l[i] = ((m[i] != 0.0) ? log(fabs(m[i])) + s[i]*log(2.0) : -HUGE_VAL);
+  auto positive = [&](double t) {
+    double top = -HUGE_VAL;
+    for(int i=1; i<=N; i++) top = std::max(top, l[i] + i*t);
+    double sum = 0.0;
+    for(int i=1; i<=N; i++) {
+      if(l[i] > -HUGE_VAL) sum += exp(l[i] + i*t - top);
+    }
+    return top + log(sum) > l[0];
+  };
+
+  double lo = 0.0, hi = 0.0, step = 1.0;
+  if(positive(0.0)) {
+    for(; positive(lo); step*=2.0) {
+      hi = lo;
+      lo -= step;
+    }
+  }
+  else {
+    for(; !positive(hi); step*=2.0) {
+      lo = hi;
+      hi += step;
+    }
+  }
+  for(int it=0; it<60; it++) {
+    double mid = 0.5*(lo + hi);
+    if(positive(mid)) hi = mid;
+    else lo = mid;
+  }
+  return exp(ldexp(lo, -k));
+}
+
+// Moduli from the polygon of the terms alone, in time linear in their number
+inline void RootModuli::estimate(const SparsePoly& poly, std::vector<double>& radius) const {
+  int n = poly.terms();
+  std::vector<int> e(n);
+  std::vector<double> l(n);
+  for(int j=0; j<n; j++) {
+    e[j] = poly.exponent(n - 1 - j);
+    l[j] = log(fabs(poly.coefficient(n - 1 - j)));
+  }
+  polygon(n, e.data(), l.data(), poly.degree(), 1.0, radius);
+}
+
+#endif
@@ -0,0 +1,156 @@
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#ifndef PolyArith_h
+#define PolyArith_h
+
+// Arithmetic on dense polynomials with real coefficients. As everywhere in roots the
+// coefficients are stored with the leading coefficient first, so C has N+1 components
+// for a polynomial of degree N.
+
+class PolyArith {
+  public:
+    double norm(const std::vector<double>& p) const;
+    void trim(std::vector<double>& p, double tol) const;
+    void monic(std::vector<double>& p) const;
+    void derivative(const std::vector<double>& p, std::vector<double>& dp) const;
+    void divide(const std::vector<double>& n, const std::vector<double>& d,
+                std::vector<double>& q, std::vector<double>& r) const;
+    void subtract(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& c) const;
+    void gcd(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& g, double tol) const;
+    void deflate(const std::vector<double>& p, int n, const double* zr, const double* zi, std::vector<double>& q) const;
+};
+
+// Largest modulus of the coefficients
+inline double PolyArith::norm(const std::vector<double>& p) const {
+  double x{0.0};
+  for(size_t j=0; j<p.size(); j++) x = std::max(x, std::fabs(p[j]));
+  return x;
+}
+
+// Drop leading coefficients that are at most tol relative to the largest one. The
+// zero polynomial is returned as the single coefficient 0.
+inline void PolyArith::trim(std::vector<double>& p, double tol) const {
+  double bound = tol*norm(p);
+  size_t k{0};
+  while(k < p.size() && std::fabs(p[k]) <= bound) k++;
+  if(k == p.size()) {
+    p.assign(1, 0.0);
+    return;
+  }
+  p.erase(p.begin(), p.begin() + k);
+}
+
+inline void PolyArith::monic(std::vector<double>& p) const {
+  double lead = p[0];
+  for(size_t j=0; j<p.size(); j++) p[j] /= lead;
+}
+
+inline void PolyArith::derivative(const std::vector<double>& p, std::vector<double>& dp) const {
+  int N = p.size() - 1;
+  if(N == 0) {
+    dp.assign(1, 0.0);
+    return;
+  }
+  dp.resize(N);
+  for(int j=0; j<N; j++) dp[j] = (double)(N - j)*p[j];
+}
+
+// Long division n = q*d + r with deg r < deg d. The leading coefficient of d is nonzero.
+inline void PolyArith::divide(const std::vector<double>& n, const std::vector<double>& d,
+                       std::vector<double>& q, std::vector<double>& r) const {
+  int nn = n.size() - 1;
+  int nd = d.size() - 1;
+  if(nn < nd) {
+    q.assign(1, 0.0);
+    r = n;
+    return;
+  }
+
+  r = n;
+  q.resize(nn - nd + 1);
+  for(int j=0; j<=nn-nd; j++) {
+    double t = r[j]/d[0];
+    q[j] = t;
+    r[j] = 0.0;
+    for(int i=1; i<=nd; i++) r[j + i] -= t*d[i];
+  }
+  if(nd == 0) {
+    r.assign(1, 0.0);
+  }
+  else {
+    r.erase(r.begin(), r.begin() + (nn - nd + 1));
+  }
+}
+
+inline void PolyArith::subtract(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& c) const {
+  int na = a.size();
+  int nb = b.size();
+  int n  = std::max(na, nb);
+  c.assign(n, 0.0);
+  for(int j=0; j<na; j++) c[n - na + j] += a[j];
+  for(int j=0; j<nb; j++) c[n - nb + j] -= b[j];
+}
+
+// Approximate monic greatest common divisor by the Euclidean algorithm. A remainder is
+// taken as zero once it is at most tol relative to the dividend.
+inline void PolyArith::gcd(const std::vector<double>& a, const std::vector<double>& b, std::vector<double>& g, double tol) const {
+  std::vector<double> u(a), v(b), q, r;
+  trim(u, 0.0);
+  trim(v, 0.0);
+  if(u.size() < v.size()) u.swap(v);
+
+  while(v.size() > 1 || v[0] != 0.0) {
+    monic(v);
+    divide(u, v, q, r);
+    double scale = norm(u);
+    if(norm(r) <= tol*scale) {
+      r.assign(1, 0.0);
+    }
+    else {
+      trim(r, tol);
+    }
+    u.swap(v);
+    v.swap(r);
+  }
+  g = u;
+  monic(g);
+}
+
+// Divide p by the factors of the n roots zr + i*zi, dropping the remainders. A non-real
+// root is divided out with its conjugate as a real quadratic; the conjugate itself is
+// skipped when it follows in the list.
+inline void PolyArith::deflate(const std::vector<double>& p, int n, const double* zr, const double* zi,
+                        std::vector<double>& q) const {
+  q = p;
+  std::vector<bool> used(n, false);
+  for(int j=0; j<n; j++) {
+    if(used[j]) continue;
+    int N = q.size()-1;
+    if(zi[j] == 0.0) {
+      // Synthetic division by x - zr
+      for(int i=1; i<N; i++) q[i] += zr[j]*q[i - 1];
+      q.resize(N);
+    }
+    else {
+      double tol = 1.0e-8*std::hypot(zr[j], zi[j]);
+      for(int i=j+1; i<n; i++) {
+        if(!used[i] && std::fabs(zr[i] - zr[j]) <= tol && std::fabs(zi[i] + zi[j]) <= tol) {
+          used[i] = true;
+          break;
+        }
+      }
+      // Synthetic division by x^2 + u x + v
+      double u = -2.0*zr[j];
+      double v = zr[j]*zr[j] + zi[j]*zi[j];
+      if(N >= 2) {
+        q[1] -= u*q[0];
+        for(int i=2; i<N-1; i++) q[i] -= u*q[i - 1] + v*q[i - 2];
+      }
+      q.resize(std::max(N - 1, 1));
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,61 @@
+import array
+import math
+import random
+import unittest
+
+import roots
+
+# The module roots from the build directory on PYTHONPATH, with arrays of the standard
+# library through the buffer protocol, so that NumPy is not needed.
+
+
+def matrix(format, rows, columns, values):
+    return memoryview(array.array(format, values)).cast('B').cast(format, [rows, columns])
+
+
+class SolveBatch(unittest.TestCase):
+    count = 50
+    N = 8
+
+    def setUp(self):
+        rng = random.Random(5)
+        self.rows = [[rng.uniform(-1.0, 1.0) for j in range(self.N + 1)] for b in range(self.count)]
+
+    def solve(self, threads):
+        c = matrix('d', self.count, self.N + 1, [x for row in self.rows for x in row])
+        zr = matrix('d', self.count, self.N, [0.0]*(self.count*self.N))
+        zi = matrix('d', self.count, self.N, [0.0]*(self.count*self.N))
+        found = memoryview(array.array('i', [0]*self.count))
+        failed = roots.solve_batch(c, zr, zi, found, threads=threads)
+        return failed, zr.tolist(), zi.tolist(), found.tolist()
+
+    def testRowsAreTheRootsOfFindRoots(self):
+        # The second call with 3 threads reuses the solver of the first
+        for threads in (1, 3, 3):
+            failed, zr, zi, found = self.solve(threads)
+            self.assertEqual(failed, 0)
+            self.assertEqual(found, [self.N]*self.count)
+            for b in range(self.count):
+                re, im = roots.find_roots(self.rows[b])
+                expected = sorted((complex(x, y) for x, y in zip(re, im)), key=lambda z: (z.real, z.imag))
+                actual = sorted((complex(x, y) for x, y in zip(zr[b], zi[b])), key=lambda z: (z.real, z.imag))
+                for x, y in zip(expected, actual):
+                    self.assertLess(abs(x - y), 1e-9*max(1.0, abs(x)))
+
+    def testZeroLeadingCoefficientLeavesNaN(self):
+        self.rows[3][0] = 0.0
+        failed, zr, zi, found = self.solve(0)
+        self.assertEqual(failed, 1)
+        self.assertEqual(found[3], 0)
+        self.assertTrue(all(math.isnan(x) for x in zr[3] + zi[3]))
+
+    def testShapesMustAgree(self):
+        c = matrix('d', 2, 4, [1.0, -6.0, 11.0, -6.0]*2)
+        zr = matrix('d', 2, 2, [0.0]*4)
+        zi = matrix('d', 2, 3, [0.0]*6)
+        with self.assertRaises(ValueError):
+            roots.solve_batch(c, zr, zi)
+
+
+if __name__ == '__main__':
+    unittest.main()
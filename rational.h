@@ -0,0 +1,233 @@
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#ifndef RationalRoots_h
+#define RationalRoots_h
+
+// Exact rational roots of polynomials with integer coefficients.
+//
+// By the rational root theorem a root p/q in lowest terms of a_0 x^N + ... + a_N has p
+// dividing a_N and q dividing a_0. Every candidate is first tested by cheap necessary
+// conditions: q - p divides f(1), q + p divides f(-1), and the homogeneous form
+// a_0 p^N + a_1 p^(N-1) q + ... + a_N q^N vanishes modulo three primes near 2^31. Before
+// them, candidates of modulus outside Fujiwara's bounds on the roots are skipped. Only a
+// candidate passing all of them is tried by synthetic division by q x - p, in exact integer
+// arithmetic, which also deflates the root; a root is tried again for its multiplicity.
+//
+// All arithmetic is checked for overflow. A candidate whose division overflows is taken as
+// no root, and a coefficient vector too large to handle is not taken as integral at all,
+// so the roots missed are left to the numerical solve rather than reported wrongly. The
+// divisors come from trial division up to trialLimit; a cofactor left over is taken as one
+// prime, which may miss candidates in the same way. Above maxCandidates candidates the
+// search is not started.
+
+class RationalRoots {
+  public:
+    RationalRoots(long long trialLimit = 65536, int maxCandidates = 100000);
+    bool integral(const std::vector<double>& c, std::vector<long long>& a) const;
+    int find(std::vector<long long>& a, std::vector<long long>& num, std::vector<long long>& den,
+             std::vector<int>& multiplicity) const;
+
+  private:
+    long long trialLimit;
+    int maxCandidates;
+
+    void divisors(long long n, std::vector<long long>& d) const;
+    bool value(const std::vector<long long>& a, long long x, long long& v) const;
+    void bounds(const std::vector<long long>& a, double& lower, double& upper) const;
+    void residues(const std::vector<long long>& a, std::vector<long long>& r) const;
+    bool filter(const std::vector<long long>& r, long long p, long long q, long long f1, long long fm1,
+                bool exact1, bool exactm1) const;
+    bool divide(std::vector<long long>& a, long long p, long long q) const;
+};
+
+inline RationalRoots::RationalRoots(long long trialLimit, int maxCandidates)
+  : trialLimit(trialLimit), maxCandidates(maxCandidates) {}
+
+// The coefficients as integers without a common factor; false unless every coefficient is
+// an integer of modulus below 2^53, where doubles are exact
+inline bool RationalRoots::integral(const std::vector<double>& c, std::vector<long long>& a) const {
+  const double top = 9007199254740992.0;
+  a.resize(c.size());
+  long long g{0};
+  for(size_t j=0; j<c.size(); j++) {
+    if(!(std::fabs(c[j]) < top) || c[j] != std::floor(c[j])) return false;
+    a[j] = (long long)c[j];
+    long long x = std::llabs(a[j]), y = g;
+    while(y != 0) {
+      long long t = x % y;
+      x = y;
+      y = t;
+    }
+    g = x;
+  }
+  if(g == 0 || a[0] == 0) return false;
+  for(size_t j=0; j<a.size(); j++) a[j] /= g;
+  return true;
+}
+
+// Positive divisors of n > 0
+inline void RationalRoots::divisors(long long n, std::vector<long long>& d) const {
+  d.assign(1, 1);
+  for(long long f=2; n > 1; f++) {
+    if(f > trialLimit || f > n/f) f = n;
+    int e{0};
+    while(n % f == 0) {
+      n /= f;
+      e++;
+    }
+    size_t m = d.size();
+    long long power{1};
+    for(int k=1; k<=e; k++) {
+      power *= f;
+      for(size_t j=0; j<m; j++) d.push_back(d[j]*power);
+    }
+    if((int)d.size() > maxCandidates) return;
+  }
+}
+
+// f(x) for x = 1 or -1; false on overflow
+inline bool RationalRoots::value(const std::vector<long long>& a, long long x, long long& v) const {
+  v = 0;
+  for(size_t j=0; j<a.size(); j++) {
+    if(__builtin_mul_overflow(v, x, &v) || __builtin_add_overflow(v, a[j], &v)) return false;
+  }
+  return true;
+}
+
+// Fujiwara's bound 2 max |a_i/a_0|^(1/i) on the moduli of the roots, above and, from the
+// reversed polynomial, below; widened against rounding. a_N is nonzero.
+inline void RationalRoots::bounds(const std::vector<long long>& a, double& lower, double& upper) const {
+  int N = a.size() - 1;
+  upper = lower = 0.0;
+  for(int i=1; i<=N; i++) {
+    upper = std::max(upper, std::pow(std::fabs((double)a[i]/(double)a[0]), 1.0/i));
+    lower = std::max(lower, std::pow(std::fabs((double)a[N - i]/(double)a[N]), 1.0/i));
+  }
+  upper *= 2.0*(1.0 + 1.0e-12);
+  lower = (1.0 - 1.0e-12)/(2.0*lower);
+}
+
+static const long long Prime[] = {2147483647, 2147483629, 2147483587};
+
+// The coefficients modulo each prime, in [0, prime), one row after the other
+inline void RationalRoots::residues(const std::vector<long long>& a, std::vector<long long>& r) const {
+  int n = a.size();
+  r.resize(3*n);
+  for(int k=0; k<3; k++) {
+    for(int j=0; j<n; j++) r[k*n + j] = ((a[j] % Prime[k]) + Prime[k]) % Prime[k];
+  }
+}
+
+// Necessary conditions for p/q to be a root, given the residues of the coefficients and
+// f(1) and f(-1) where they are exact
+inline bool RationalRoots::filter(const std::vector<long long>& r, long long p, long long q, long long f1, long long fm1,
+                           bool exact1, bool exactm1) const {
+  if(exact1 && ((q - p == 0) ? f1 != 0 : f1 % (q - p) != 0)) return false;
+  if(exactm1 && ((q + p == 0) ? fm1 != 0 : fm1 % (q + p) != 0)) return false;
+
+  int n = r.size()/3;
+  for(int k=0; k<3; k++) {
+    long long m = Prime[k];
+    long long pm = ((p % m) + m) % m, qm = q % m;
+    const long long* a = &r[k*n];
+    // Homogeneous Horner scheme: v_j = v_(j-1) p + a_j q^j, all below 2^31
+    long long v{0};
+    if(qm == 1) {
+      for(int j=0; j<n; j++) v = (v*pm + a[j]) % m;
+    }
+    else {
+      long long qj{1};
+      for(int j=0; j<n; j++) {
+        v = (v*pm + a[j]*qj % m) % m;
+        qj = qj*qm % m;
+      }
+    }
+    if(v != 0) return false;
+  }
+  return true;
+}
+
+// a = (q x - p) b exactly: a is replaced by b and true returned, or a is left alone
+inline bool RationalRoots::divide(std::vector<long long>& a, long long p, long long q) const {
+  int N = a.size() - 1;
+  std::vector<long long> b(N);
+  long long prev{0};
+  for(int i=0; i<N; i++) {
+    long long t;
+    if(__builtin_mul_overflow(p, prev, &t) || __builtin_add_overflow(a[i], t, &t)) return false;
+    if(t % q != 0) return false;
+    b[i] = prev = t/q;
+  }
+  long long r;
+  if(__builtin_mul_overflow(p, prev, &r) || __builtin_add_overflow(a[N], r, &r) || r != 0) return false;
+  a.swap(b);
+  return true;
+}
+
+// Deflates a by all its rational roots num[k]/den[k], den[k] > 0, each with its
+// multiplicity, and returns their number counted once each
+inline int RationalRoots::find(std::vector<long long>& a, std::vector<long long>& num, std::vector<long long>& den,
+                        std::vector<int>& multiplicity) const {
+  num.clear();
+  den.clear();
+  multiplicity.clear();
+
+  int zeros{0};
+  while(a.size() > 1 && a.back() == 0) {
+    a.pop_back();
+    zeros++;
+  }
+  if(zeros > 0) {
+    num.push_back(0);
+    den.push_back(1);
+    multiplicity.push_back(zeros);
+  }
+  if(a.size() < 2) return num.size();
+
+  std::vector<long long> dp, dq;
+  divisors(std::llabs(a.back()), dp);
+  divisors(std::llabs(a[0]), dq);
+  if((double)dp.size()*(double)dq.size() > maxCandidates) return num.size();
+
+  long long f1{0}, fm1{0};
+  bool exact1 = value(a, 1, f1), exactm1 = value(a, -1, fm1);
+  double lower, upper;
+  bounds(a, lower, upper);
+  std::vector<long long> r;
+  residues(a, r);
+  for(size_t i=0; i<dp.size() && a.size() > 1; i++) {
+    for(size_t j=0; j<dq.size() && a.size() > 1; j++) {
+      double z = (double)dp[i]/(double)dq[j];
+      if(z < lower || z > upper) continue;
+      // Divisors of the coefficients of the deflated polynomial, in lowest terms
+      if(a.back() % dp[i] != 0 || a[0] % dq[j] != 0) continue;
+      long long x = dp[i], y = dq[j];
+      while(y != 0) {
+        long long t = x % y;
+        x = y;
+        y = t;
+      }
+      if(x != 1) continue;
+
+      for(int s=1; s>=-1; s-=2) {
+        long long p = s*dp[i], q = dq[j];
+        if(!filter(r, p, q, f1, fm1, exact1, exactm1)) continue;
+        int m{0};
+        while(a.size() > 1 && divide(a, p, q)) m++;
+        if(m == 0) continue;
+        num.push_back(p);
+        den.push_back(q);
+        multiplicity.push_back(m);
+        exact1 = value(a, 1, f1);
+        exactm1 = value(a, -1, fm1);
+        residues(a, r);
+      }
+    }
+  }
+  return num.size();
+}
+
+#endif
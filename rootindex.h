@@ -0,0 +1,176 @@
+#include "helper.h"
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#ifndef RootIndex_h
+#define RootIndex_h
+
+// Sorted index over a computed set of roots. Real roots are sorted by value and all
+// roots are sorted by real part, modulus and argument, so the range queries below
+// cost a binary search plus the size of the answer.
+
+class RootIndex {
+  int nRoot;
+
+  public:
+    RootIndex(void);
+    ~RootIndex(void);
+    void build(int degree, const double* zeror, const double* zeroi, double rtol = 0.0, double atol = 0.0);
+    int size(void) const;
+    int realRootsIn(double a, double b, std::vector<double>& zr) const;
+    int rootsInAnnulus(double r1, double r2, std::vector<double>& zr, std::vector<double>& zi) const;
+    int rootsInSector(double theta1, double theta2, std::vector<double>& zr, std::vector<double>& zi) const;
+    int rootsRightOf(double x, std::vector<double>& zr, std::vector<double>& zi) const;
+    int nearestRoots(int k, double xr, double xi, std::vector<double>& zr, std::vector<double>& zi) const;
+
+  private:
+    Helper helper;
+
+    // Roots in order of increasing real part
+    std::vector<double> re;
+    std::vector<double> im;
+
+    std::vector<double> real;
+    std::vector<double> modKey;
+    std::vector<int> modIdx;
+    std::vector<double> argKey;
+    std::vector<int> argIdx;
+
+    void sortKeys(std::vector<double>& key, std::vector<int>& idx);
+    int collect(const std::vector<int>& idx, int lo, int hi, std::vector<double>& zr, std::vector<double>& zi) const;
+};
+
+inline RootIndex::RootIndex(void) : nRoot(0) {}
+
+inline RootIndex::~RootIndex(void) {}
+
+inline void RootIndex::build(int degree, const double* zeror, const double* zeroi, double rtol, double atol) {
+  std::vector<int> order(degree);
+  for(int j=0; j<degree; j++) order[j] = j;
+  std::sort(order.begin(), order.end(), [zeror](int a, int b) { return zeror[a] < zeror[b]; });
+
+  nRoot = degree;
+  re.resize(nRoot);
+  im.resize(nRoot);
+  real.clear();
+  for(int j=0; j<nRoot; j++) {
+    re[j] = zeror[order[j]];
+    im[j] = zeroi[order[j]];
+    // Same classification as Roots::findRealRoots
+    if(helper.nearly_real(re[j], im[j], rtol, atol)) real.push_back(re[j]);
+  }
+
+  modKey.resize(nRoot);
+  argKey.resize(nRoot);
+  for(int j=0; j<nRoot; j++) {
+    modKey[j] = std::hypot(re[j], im[j]);
+    argKey[j] = std::atan2(im[j], re[j]);
+  }
+  sortKeys(modKey, modIdx);
+  sortKeys(argKey, argIdx);
+}
+
+inline void RootIndex::sortKeys(std::vector<double>& key, std::vector<int>& idx) {
+  idx.resize(nRoot);
+  for(int j=0; j<nRoot; j++) idx[j] = j;
+  std::sort(idx.begin(), idx.end(), [&key](int a, int b) { return key[a] < key[b]; });
+
+  std::vector<double> sorted(nRoot);
+  for(int j=0; j<nRoot; j++) sorted[j] = key[idx[j]];
+  key.swap(sorted);
+}
+
+inline int RootIndex::collect(const std::vector<int>& idx, int lo, int hi,
+                       std::vector<double>& zr, std::vector<double>& zi) const {
+  for(int j=lo; j<hi; j++) {
+    zr.push_back(re[idx[j]]);
+    zi.push_back(im[idx[j]]);
+  }
+  return hi - lo;
+}
+
+inline int RootIndex::size(void) const {
+  return nRoot;
+}
+
+// Real roots x with a <= x <= b, in increasing order
+inline int RootIndex::realRootsIn(double a, double b, std::vector<double>& zr) const {
+  std::vector<double>::const_iterator lo = std::lower_bound(real.begin(), real.end(), a);
+  std::vector<double>::const_iterator hi = std::upper_bound(lo, real.end(), b);
+  zr.insert(zr.end(), lo, hi);
+  return hi - lo;
+}
+
+// Roots z with r1 <= |z| <= r2, in increasing modulus
+inline int RootIndex::rootsInAnnulus(double r1, double r2, std::vector<double>& zr, std::vector<double>& zi) const {
+  int lo = std::lower_bound(modKey.begin(), modKey.end(), r1) - modKey.begin();
+  int hi = std::upper_bound(modKey.begin() + lo, modKey.end(), r2) - modKey.begin();
+  return collect(modIdx, lo, hi, zr, zi);
+}
+
+// Roots z with theta1 <= arg(z) <= theta2, where arg is taken in (-pi, pi]
+inline int RootIndex::rootsInSector(double theta1, double theta2, std::vector<double>& zr, std::vector<double>& zi) const {
+  int lo = std::lower_bound(argKey.begin(), argKey.end(), theta1) - argKey.begin();
+  int hi = std::upper_bound(argKey.begin() + lo, argKey.end(), theta2) - argKey.begin();
+  return collect(argIdx, lo, hi, zr, zi);
+}
+
+// Roots z with Re(z) > x, in increasing real part. Re(z) > 0 is rootsRightOf(0.0, ...)
+inline int RootIndex::rootsRightOf(double x, std::vector<double>& zr, std::vector<double>& zi) const {
+  int lo = std::upper_bound(re.begin(), re.end(), x) - re.begin();
+  zr.insert(zr.end(), re.begin() + lo, re.end());
+  zi.insert(zi.end(), im.begin() + lo, im.end());
+  return nRoot - lo;
+}
+
+// The k roots nearest to xr + i*xi, closest first. The search sweeps outward in real
+// part from xr and stops on each side once the real distance alone exceeds the
+// k-th best distance found so far.
+inline int RootIndex::nearestRoots(int k, double xr, double xi, std::vector<double>& zr, std::vector<double>& zi) const {
+  k = std::min(k, nRoot);
+  if(k <= 0) return 0;
+
+  // Max-heap on squared distance holding the k best candidates
+  std::vector<std::pair<double,int> > best;
+  int right = std::lower_bound(re.begin(), re.end(), xr) - re.begin();
+  int left  = right - 1;
+
+  while(left >= 0 || right < nRoot) {
+    bool full = ((int)best.size() == k);
+    double dl = (left >= 0) ? xr - re[left] : HUGE_VAL;
+    double dr = (right < nRoot) ? re[right] - xr : HUGE_VAL;
+    int j;
+    if(dl <= dr) {
+      if(full && dl*dl >= best.front().first) break;
+      j = left--;
+    }
+    else {
+      if(full && dr*dr >= best.front().first) break;
+      j = right++;
+    }
+
+    double dx = re[j] - xr;
+    double dy = im[j] - xi;
+    double d2 = dx*dx + dy*dy;
+    if(!full) {
+      best.push_back(std::make_pair(d2, j));
+      std::push_heap(best.begin(), best.end());
+    }
+    else if(d2 < best.front().first) {
+      std::pop_heap(best.begin(), best.end());
+      best.back() = std::make_pair(d2, j);
+      std::push_heap(best.begin(), best.end());
+    }
+  }
+
+  std::sort_heap(best.begin(), best.end());
+  for(int j=0; j<k; j++) {
+    zr.push_back(re[best[j].second]);
+    zi.push_back(im[best[j].second]);
+  }
+  return k;
+}
+
+#endif
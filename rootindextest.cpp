@@ -0,0 +1,68 @@
+#include "gmock/gmock.h"
+
+#include "rootindex.h"
+
+#include <vector>
+#include <cmath>
+
+using namespace testing;
+
+class Index: public Test {
+  public:
+    RootIndex index;
+    // Roots of (x+2)(x-0.5)(x-3)(x^2-2x+5)(x^2+4x+13)
+    double zr[7] = {-2.0, 0.5, 3.0, 1.0,  1.0, -2.0, -2.0};
+    double zi[7] = { 0.0, 0.0, 0.0, 2.0, -2.0,  3.0, -3.0};
+
+    void SetUp() override {
+      index.build(7, zr, zi);
+    }
+};
+
+TEST_F(Index, SizeIsNumberOfRoots) {
+  ASSERT_THAT(index.size(), Eq(7));
+}
+
+TEST_F(Index, RealRootsInIntervalAreSorted) {
+  std::vector<double> r;
+  ASSERT_THAT(index.realRootsIn(-2.0, 1.0, r), Eq(2));
+  ASSERT_THAT(r, ElementsAre(-2.0, 0.5));
+}
+
+TEST_F(Index, RealRootsInEmptyInterval) {
+  std::vector<double> r;
+  ASSERT_THAT(index.realRootsIn(0.6, 2.9, r), Eq(0));
+  ASSERT_TRUE(r.empty());
+}
+
+TEST_F(Index, RootsInAnnulus) {
+  std::vector<double> r, i;
+  ASSERT_THAT(index.rootsInAnnulus(2.0, 3.0, r, i), Eq(4));
+  ASSERT_THAT(r, ElementsAre(-2.0, 1.0, 1.0, 3.0));
+  ASSERT_THAT(std::fabs(i[1]), Eq(2.0));
+}
+
+TEST_F(Index, RootsInUpperHalfPlaneSector) {
+  std::vector<double> r, i;
+  ASSERT_THAT(index.rootsInSector(0.1, 3.0, r, i), Eq(2));
+  ASSERT_THAT(i, ElementsAre(2.0, 3.0));
+}
+
+TEST_F(Index, RootsWithPositiveRealPart) {
+  std::vector<double> r, i;
+  ASSERT_THAT(index.rootsRightOf(0.0, r, i), Eq(4));
+  ASSERT_THAT(r, ElementsAre(0.5, 1.0, 1.0, 3.0));
+}
+
+TEST_F(Index, NearestRootsClosestFirst) {
+  std::vector<double> r, i;
+  ASSERT_THAT(index.nearestRoots(2, 1.0, 1.5, r, i), Eq(2));
+  ASSERT_THAT(r, ElementsAre(1.0, 0.5));
+  ASSERT_THAT(i, ElementsAre(2.0, 0.0));
+}
+
+TEST_F(Index, NearestRootsLimitedToIndexSize) {
+  std::vector<double> r, i;
+  ASSERT_THAT(index.nearestRoots(20, -10.0, 0.0, r, i), Eq(7));
+  ASSERT_THAT(r[0], Eq(-2.0));
+}
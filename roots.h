@@ -1,49 +1,126 @@
 #include "rpoly.h"
 #include "helper.h"
+#include "rootindex.h"
+#include "squarefree.h"
+#include "structure.h"
+#include "mapped.h"
+#include "stability.h"
+#include "sturm.h"
+#include "moduli.h"
+#include "rational.h"
+#include "bezier.h"
+#include "chebyshev.h"
+#include "trace.h"
 
 #include <vector>
+#include <stdexcept>
 
 #ifndef Roots_h
 #define Roots_h
 
+// Roots of one polynomial, as the batch and asynchronous front ends deliver them
+struct RootResult {
+  RootStatus status{RootStatus::Success};
+  int found{0};
+  std::vector<double> zr;
+  std::vector<double> zi;
+};
+
 class Roots {
   int maxDegree;
   int mdp1;
   int degree;
+  int found;
   int realRoots;
 
   public:
     Roots(RPoly* rpoly);
     ~Roots(void);
     int getMaxDegree(void) const;
-    void findRoots(const std::vector<double>& coeff);
+    void setSquareFree(bool on);
+    void setStructuralReduction(bool on);
+    void setRationalRoots(bool on);
+    void findRoots(const std::vector<double>& coeff, double rtol = 0.0, double atol = 0.0);
+    void findRoots(const SparsePoly& poly);
+    void findRoots(const MappedPoly& poly);
+    RootStatus solve(const std::vector<double>& coeff, int& nFound, double rtol = 0.0, double atol = 0.0) noexcept;
     void findRealRoots(void);
     void getRoots(int& Degree, std::vector<double>& zr, std::vector<double>& zi) const;
     void getRoots(int& Degree, std::vector<double>& zr) const;
+    void getFoundRoots(std::vector<double>& zr, std::vector<double>& zi) const;
+    void getMultiplicities(std::vector<int>& mult) const;
+    void getRemainder(std::vector<double>& rem) const;
     double getAbsMinRealRoot(void) const;
     double getMinPosRealRoot(void) const;
     double getMaxPosRealRoot(void) const;
     double getMinNegRealRoot(void) const;
     double getMaxNegRealRoot(void) const;
+    void indexRoots(void);
+    const RootIndex& getRootIndex(void) const;
+    bool isHurwitzStable(const std::vector<double>& coeff) const;
+    bool isSchurStable(const std::vector<double>& coeff) const;
+    int countRealRoots(const std::vector<double>& coeff, double a, double b);
+    void findBezierRoots(const std::vector<double>& b, std::vector<double>& t) const;
+    void findChebyshevRoots(const std::vector<double>& c, std::vector<double>& x) const;
+    void beginRoots(const std::vector<double>& coeff);
+    bool nextRoot(double& zr, double& zi);
 
   private:
     RPoly* rpoly_;
     Helper helper;
+    RootIndex index;
+    SquareFree squarefree;
+    bool squareFree{false};
+    Structure structure;
+    Stability stability;
+    SturmChain sturm;
+    BezierRoots bezier;
+    ChebyshevRoots chebyshev;
+    bool structural{false};
+    RationalRoots rational;
+    bool rationalRoots{false};
+    std::vector<int> multiplicity;
+    PolyArith arith;
+
+    // Exception-free mode of the solve behind solve()
+    bool nothrow{false};
+    RootStatus status{RootStatus::Success};
+    std::vector<double> lastCoeff;
+
+    // Lazy solve: roots stored by the solver, and handed out to the caller
+    int lazyFound{0};
+    int lazyTaken{0};
+    // More Graeffe steps than for the estimates, for a tight bound: a factor of N^(1/64)
+    RootModuli bound{6};
+
+    int smallest(void) const;
 
     double* zeror{nullptr};
     double* zeroi{nullptr};
     double* op{nullptr};
+
+    double rtol{0.0};
+    double atol{0.0};
+
+    void setAccuracy(double rtol, double atol);
+    int solvePipeline(const std::vector<double>& coeff);
+    int solveFactor(const std::vector<double>& coeff, double* zr, double* zi);
+    int solveDirect(const std::vector<double>& coeff, double* zr, double* zi);
+    bool solveReduced(const std::vector<double>& coeff, double* zr, double* zi, int& nFound);
+    bool findSquareFreeRoots(const std::vector<double>& coeff, int first, int& nFound);
+    int findRationalRoots(const std::vector<double>& coeff, std::vector<double>& rest);
 };
 
-Roots::Roots(RPoly* rpoly) : rpoly_(rpoly) {
+inline Roots::Roots(RPoly* rpoly) : rpoly_(rpoly) {
   maxDegree = rpoly_->maxDegree;
   mdp1  = rpoly_->mdp1;
+  degree = found = realRoots = 0;
   zeror = new double[maxDegree];
   zeroi = new double[maxDegree];
   op    = new double[mdp1];
 }
 
-Roots::~Roots(void) {
+inline Roots::~Roots(void) {
   delete [] zeror;
   delete [] zeroi;
   delete [] op;
@@ -53,33 +130,249 @@ Roots::~Roots(void) {
   rpoly_= nullptr;
 }
 
-int Roots::getMaxDegree(void) const {
+inline int Roots::getMaxDegree(void) const {
   return maxDegree;
 }
 
-void Roots::findRoots(const std::vector<double>& coeff) {
+// Split the polynomial into square-free factors before the solve. Multiple roots are
+// then found once, as simple roots of their factor, and repeated by multiplicity.
+inline void Roots::setSquareFree(bool on) {
+  squareFree = on;
+}
+
+// Detect polynomials in x^k and palindromic or anti-palindromic polynomials and
+// solve the smaller problem they reduce to
+inline void Roots::setStructuralReduction(bool on) {
+  structural = on;
+}
+
+// Find the rational roots of polynomials with integer coefficients exactly and solve only
+// the factor that remains. These roots carry their multiplicity.
+inline void Roots::setRationalRoots(bool on) {
+  rationalRoots = on;
+}
+
+// rtol and atol ask for the roots to within atol + rtol*|z| only. The iterations stop as
+// soon as that accuracy is reached and a root counts as real if its imaginary part is
+// within the same tolerance. Zero for both asks for full precision.
+inline void Roots::findRoots(const std::vector<double>& coeff, double rtol, double atol) {
   degree = coeff.size()-1;
-  for(int j=0; j<=degree; j++) {
+  TraceScope trace(TracePoint::FindRoots, degree, rpoly_->name());
+  nothrow = false;
+  lastCoeff = coeff;
+  setAccuracy(rtol, atol);
+
+  // Invalid input goes straight to rpoly, which reports it
+  bool valid = (degree <= maxDegree && coeff[0] != 0.0);
+  if(!valid) {
+    solveDirect(coeff, zeror, zeroi);
+  }
+  else {
+    solvePipeline(coeff);
+  }
+  found = degree;
+
+  findRealRoots();
+}
+
+// Exception-free findRoots for batch use. Returns the status and the number of roots
+// found; on failure to converge the roots found so far are available through getRoots
+// and the polynomial of the remaining roots through getRemainder.
+inline RootStatus Roots::solve(const std::vector<double>& coeff, int& nFound, double rtol, double atol) noexcept {
+  degree = coeff.size()-1;
+  TraceScope trace(TracePoint::FindRoots, degree, rpoly_->name());
+  nothrow = true;
+  status = RootStatus::Success;
+  lastCoeff = coeff;
+  setAccuracy(rtol, atol);
+
+  if(degree > maxDegree) {
+    status = RootStatus::DegreeTooLarge;
+    found = 0;
+  }
+  else if(coeff[0] == 0.0) {
+    status = RootStatus::LeadingCoefficientZero;
+    found = 0;
+  }
+  else {
+    found = solvePipeline(coeff);
+  }
+  multiplicity.resize(found);
+
+  findRealRoots();
+  nFound = found;
+  return status;
+}
+
+// Sparse input is handed to the solver as is. Solvers that iterate on the terms, like
+// Aberth, never touch the zero coefficients; others densify into op.
+inline void Roots::findRoots(const SparsePoly& poly) {
+  degree = poly.degree();
+  TraceScope trace(TracePoint::FindRoots, degree, rpoly_->name());
+  setAccuracy(0.0, 0.0);
+
+  rpoly_->initialize();
+  rpoly_->rpolySparse(poly, op, zeror, zeroi);
+  multiplicity.assign(degree, 1);
+  found = degree;
+
+  findRealRoots();
+}
+
+// Coefficients mapped from a file go to the solver without a copy. Meant for very high
+// degree with a solver like FastAberth, so the reductions are skipped.
+inline void Roots::findRoots(const MappedPoly& poly) {
+  degree = poly.degree();
+  TraceScope trace(TracePoint::FindRoots, degree, rpoly_->name());
+  setAccuracy(0.0, 0.0);
+
+  rpoly_->initialize();
+  rpoly_->rpoly(poly.data(), degree, zeror, zeroi);
+  multiplicity.assign(degree, 1);
+  found = degree;
+
+  findRealRoots();
+}
+
+inline void Roots::setAccuracy(double r, double a) {
+  rtol = r;
+  atol = a;
+  rpoly_->setAccuracy(rtol, atol);
+}
+
+// The solve behind findRoots and solve. Each stage returns the number of roots stored
+// from the front of its output, all of them unless a solve failed to converge.
+inline int Roots::solvePipeline(const std::vector<double>& coeff) {
+  multiplicity.clear();
+  std::vector<double> rest;
+  int k = (rationalRoots ? findRationalRoots(coeff, rest) : 0);
+  const std::vector<double>& p = ((k > 0) ? rest : coeff);
+  if(p.size() == 1) return k;
+
+  int n;
+  if(!(squareFree && findSquareFreeRoots(p, k, n))) {
+    n = solveFactor(p, &zeror[k], &zeroi[k]);
+    multiplicity.insert(multiplicity.end(), n, 1);
+  }
+  return k + n;
+}
+
+// Stores the rational roots of coeff from the front of zeror, zeroi and the factor of the
+// other roots in rest; returns the number of roots stored
+inline int Roots::findRationalRoots(const std::vector<double>& coeff, std::vector<double>& rest) {
+  std::vector<long long> a, num, den;
+  std::vector<int> mult;
+  if(!rational.integral(coeff, a)) return 0;
+
+  int k{0};
+  int n = rational.find(a, num, den, mult);
+  for(int r=0; r<n; r++) {
+    for(int m=0; m<mult[r]; m++) {
+      zeror[k] = (double)num[r]/(double)den[r];
+      zeroi[k] = 0.0;
+      multiplicity.push_back(mult[r]);
+      k++;
+    }
+  }
+  rest.assign(a.begin(), a.end());
+  return k;
+}
+
+inline int Roots::solveFactor(const std::vector<double>& coeff, double* zr, double* zi) {
+  int n;
+  if(!(structural && solveReduced(coeff, zr, zi, n))) {
+    n = solveDirect(coeff, zr, zi);
+  }
+  return n;
+}
+
+inline int Roots::solveDirect(const std::vector<double>& coeff, double* zr, double* zi) {
+  int n = coeff.size()-1;
+  for(int j=0; j<=n; j++) {
     op[j] = coeff[j];
   }
 
   rpoly_->initialize();
   // Know length(coeff) .leq. length(op) because degree .leq. rpoly_->maxDegree
-  rpoly_->rpoly(op, degree, zeror, zeroi);
+  if(!nothrow) {
+    rpoly_->rpoly(op, n, zr, zi);
+    return n;
+  }
 
-  findRealRoots();
+  int nf;
+  RootStatus st = rpoly_->solve(op, n, zr, zi, &nf);
+  if(st != RootStatus::Success) status = st;
+  return nf;
+}
+
+inline bool Roots::solveReduced(const std::vector<double>& coeff, double* zr, double* zi, int& nFound) {
+  int N = coeff.size()-1;
+  if(N < 3) return false;
+
+  std::vector<double> q;
+  int zeros;
+  int k = structure.lacunarity(coeff, zeros);
+  if(k > 1) {
+    structure.substitute(coeff, k, zeros, q);
+    int n = q.size()-1;
+    std::vector<double> yr(n), yi(n);
+    int nf = solveFactor(q, yr.data(), yi.data());
+    for(int j=0; j<zeros; j++) zr[j] = zi[j] = 0.0;
+    structure.expandPowers(nf, yr.data(), yi.data(), k, &zr[zeros], &zi[zeros]);
+    nFound = zeros + k*nf;
+    return true;
+  }
+
+  int sign = structure.reciprocal(coeff);
+  if(sign == 0) return false;
+
+  int nlin = structure.splitReciprocal(coeff, sign, q, zr, zi);
+  int m = (q.size()-1)/2;
+  nFound = nlin;
+  if(m > 0) {
+    std::vector<double> w, wr(m), wi(m);
+    structure.fold(q, w);
+    int nf = solveFactor(w, wr.data(), wi.data());
+    structure.unfold(nf, wr.data(), wi.data(), &zr[nlin], &zi[nlin]);
+    nFound += 2*nf;
+  }
+  return true;
 }
 
-void Roots::findRealRoots(void) {
+// Stores the roots from zeror[first] on, appending their multiplicities
+inline bool Roots::findSquareFreeRoots(const std::vector<double>& coeff, int first, int& nFound) {
+  std::vector<std::vector<double> > factors;
+  std::vector<int> mult;
+  if(!squarefree.factor(coeff, factors, mult)) return false;
+
+  int k = first;
+  for(size_t f=0; f<factors.size(); f++) {
+    int n  = factors[f].size()-1;
+    int nf = solveFactor(factors[f], &zeror[k], &zeroi[k]);
+    for(int m=1; m<mult[f]; m++) {
+      for(int j=0; j<nf; j++) {
+        zeror[k + m*nf + j] = zeror[k + j];
+        zeroi[k + m*nf + j] = zeroi[k + j];
+      }
+    }
+    multiplicity.insert(multiplicity.end(), mult[f]*nf, mult[f]);
+    k += mult[f]*nf;
+    if(nf < n) break;
+  }
+  nFound = k - first;
+  return true;
+}
+
+inline void Roots::findRealRoots(void) {
   realRoots=0;
-  for(int j=0;j<degree;j++) {
-    if(helper.nearly_equal(zeroi[j], 0.0, 10)) {
+  for(int j=0;j<found;j++) {
+    if(helper.nearly_real(zeror[j], zeroi[j], rtol, atol)) {
       op[realRoots++] = zeror[j];
     }
   }
 }
 
-void Roots::getRoots(int& Degree, std::vector<double>& zr, std::vector<double>& zi) const {
+inline void Roots::getRoots(int& Degree, std::vector<double>& zr, std::vector<double>& zi) const {
   Degree = degree;
   for(int j=0; j<=degree; j++) {
     zr.push_back(zeror[j]);
@@ -87,32 +380,170 @@ void Roots::getRoots(int& Degree, std::vector<double>& zr, std::vector<double>&
   }
 }
 
-void Roots::getRoots(int& real, std::vector<double>& zr) const {
+// The roots found by the last solve and nothing past them, replacing the contents of zr
+// and zi; within their capacity this does not allocate
+inline void Roots::getFoundRoots(std::vector<double>& zr, std::vector<double>& zi) const {
+  zr.assign(zeror, zeror + found);
+  zi.assign(zeroi, zeroi + found);
+}
+
+inline void Roots::getRoots(int& real, std::vector<double>& zr) const {
   real = realRoots;
   for(int j=0; j<=realRoots; j++) {
     zr.push_back(op[j]);
   }
 }
 
-double Roots::getAbsMinRealRoot(void) const {
+// Multiplicity of each root returned by getRoots. Without square-free preprocessing
+// every root is reported as simple, except for the exact rational roots.
+inline void Roots::getMultiplicities(std::vector<int>& mult) const {
+  mult = multiplicity;
+}
+
+// The polynomial whose roots are those not found by the last solve: the coefficients
+// deflated by every root found. A complex root is divided out together with its conjugate.
+inline void Roots::getRemainder(std::vector<double>& rem) const {
+  arith.deflate(lastCoeff, found, zeror, zeroi, rem);
+}
+
+inline double Roots::getAbsMinRealRoot(void) const {
   return helper.absmin(realRoots, op);
 }
 
-double Roots::getMinPosRealRoot(void) const {
+inline double Roots::getMinPosRealRoot(void) const {
   return helper.minpos(realRoots, op);
 }
 
-double Roots::getMaxPosRealRoot(void) const {
+inline double Roots::getMaxPosRealRoot(void) const {
   return helper.maxpos(realRoots, op);
 }
 
-double Roots::getMinNegRealRoot(void) const {
+inline double Roots::getMinNegRealRoot(void) const {
   return helper.minneg(realRoots, op);
 }
 
-double Roots::getMaxNegRealRoot(void) const {
+inline double Roots::getMaxNegRealRoot(void) const {
   return helper.maxneg(realRoots, op);
 }
 
-#endif
+// Build the sorted index over the roots of the last findRoots for range,
+// annulus and nearest-root queries
+inline void Roots::indexRoots(void) {
+  index.build(found, zeror, zeroi, rtol, atol);
+}
+
+inline const RootIndex& Roots::getRootIndex(void) const {
+  return index;
+}
+
+// True if all roots lie in the open left half-plane, decided by the Routh array without
+// a solve. Roots on the imaginary axis make the polynomial not stable.
+inline bool Roots::isHurwitzStable(const std::vector<double>& coeff) const {
+  return stability.hurwitz(coeff);
+}
+
+// True if all roots lie in the open unit disk, decided by the Schur-Cohn recursion
+// without a solve. Roots on the unit circle make the polynomial not stable.
+inline bool Roots::isSchurStable(const std::vector<double>& coeff) const {
+  return stability.schur(coeff);
+}
+
+// Number of distinct real roots in [a, b] by a Sturm chain, without a solve. The chain of
+// the last polynomial is kept, so repeated queries on it only evaluate the chain at a
+// and b.
+inline int Roots::countRealRoots(const std::vector<double>& coeff, double a, double b) {
+  if (!sturm.matches(coeff))   sturm.build(coeff);
+  return sturm.count(a, b);
+}
 
+// Roots in [0, 1] of the polynomial with Bernstein coefficients b, in increasing order.
+// The solver is not involved: the roots come from Bezier clipping in the Bernstein basis.
+inline void Roots::findBezierRoots(const std::vector<double>& b, std::vector<double>& t) const {
+  bezier.find(b, t);
+}
+
+// Real roots in [-1, 1] of c_0 T_0 + ... + c_n T_n, in increasing order. The Chebyshev
+// coefficients come in order of increasing degree. Pieces of low degree are solved by the
+// solver in the monomial basis, which ends a lazy solve under way.
+inline void Roots::findChebyshevRoots(const std::vector<double>& c, std::vector<double>& x) const {
+  chebyshev.find(c, *rpoly_, x);
+}
+
+// Lazy solve for the few smallest roots. beginRoots starts the solve of coeff and each
+// nextRoot returns one further root, in order of nondecreasing modulus. A root found is
+// held back until it is certified as the smallest of those left: its modulus must be at
+// most a lower bound on the roots of the polynomial deflated by all roots found so far.
+// With Akiti the deflation continues only until then, so asking for a few small roots of
+// a large polynomial costs a few deflations. Other solvers find all roots at once. The
+// reductions of findRoots are skipped.
+inline void Roots::beginRoots(const std::vector<double>& coeff) {
+  degree = coeff.size()-1;
+  found = realRoots = 0;
+  lazyFound = lazyTaken = 0;
+  setAccuracy(0.0, 0.0);
+
+  if(degree > maxDegree) {
+    throw std::invalid_argument( "Requested maximal degree is greater than MAXDEGREE." );
+  }
+  for(int j=0; j<=degree; j++) {
+    op[j] = coeff[j];
+  }
+  lastCoeff = coeff;
+
+  rpoly_->initialize();
+  if(rpoly_->begin(op, degree, zeror, zeroi) == RootStatus::LeadingCoefficientZero) {
+    throw std::invalid_argument( "The leading coefficient is zero." );
+  }
+}
+
+// Index of the found root of least modulus not yet returned, or -1
+inline int Roots::smallest(void) const {
+  int k = -1;
+  double m = 0.0;
+  for(int j=lazyTaken; j<lazyFound; j++) {
+    double r = std::hypot(zeror[j], zeroi[j]);
+    if(k < 0 || r < m) {
+      k = j;
+      m = r;
+    }
+  }
+  return k;
+}
+
+// False once all roots have been returned
+inline bool Roots::nextRoot(double& zr, double& zi) {
+  if(lazyTaken == degree) return false;
+  std::vector<double> rem;
+  int k;
+  for(;;) {
+    k = smallest();
+    if(k >= 0) {
+      if(lazyFound == degree) break;
+      arith.deflate(lastCoeff, lazyFound, zeror, zeroi, rem);
+      if(std::hypot(zeror[k], zeroi[k]) <= bound.lowerBound(rem.data(), rem.size()-1)) break;
+    }
+    int n = lazyFound;
+    if(rpoly_->next(&lazyFound) != RootStatus::Success || lazyFound == n) {
+      throw std::runtime_error( "Failure to converge before all roots were found." );
+    }
+  }
+
+  std::swap(zeror[k], zeror[lazyTaken]);
+  std::swap(zeroi[k], zeroi[lazyTaken]);
+  zr = zeror[lazyTaken];
+  zi = zeroi[lazyTaken];
+  lazyTaken++;
+  // The conjugate, of the same modulus, is returned next
+  if(zi != 0.0) {
+    for(int j=lazyTaken; j<lazyFound; j++) {
+      if(zeror[j] == zr && zeroi[j] == -zi) {
+        std::swap(zeror[j], zeror[lazyTaken]);
+        std::swap(zeroi[j], zeroi[lazyTaken]);
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+#endif
@@ -0,0 +1,60 @@
+#include "server.h"
+#include "trace.h"
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <cstdlib>
+#include <stdexcept>
+#include <signal.h>
+
+// Solver daemon:
+//
+//   rootsd socket [maxDegree] [threads] [maxBatch]
+//
+// Serves RootClient on the Unix domain socket until SIGINT or SIGTERM, then answers the
+// requests already taken and removes the socket.
+//
+// With ROOTS_METRICS set to a file, traces the solves and writes their metrics there every
+// ten seconds; with ROOTS_TRACE set to a file, writes the last spans there as a Chrome
+// trace on exit.
+
+int main(int argc, char** argv) {
+  if(argc < 2) {
+    std::cerr << "usage: " << argv[0] << " socket [maxDegree] [threads] [maxBatch]" << std::endl;
+    return 2;
+  }
+  std::string path = argv[1];
+  int maxDegree = ((argc > 2) ? std::atoi(argv[2]) : 100);
+  int threads = ((argc > 3) ? std::atoi(argv[3]) : 0);
+  int maxBatch = ((argc > 4) ? std::atoi(argv[4]) : 32);
+
+  // Blocked before any thread starts, so that every thread inherits the mask and the
+  // signals are only taken here
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  const char* metrics = std::getenv("ROOTS_METRICS");
+  const char* trace = std::getenv("ROOTS_TRACE");
+  if(metrics != nullptr || trace != nullptr)   Tracer::enable(true);
+
+  try {
+    std::unique_ptr<MetricsExporter> exporter;
+    if(metrics != nullptr)   exporter.reset(new MetricsExporter(metrics, 10.0));
+    RootServer server(path, maxDegree, threads, maxBatch);
+    std::cout << "serving " << path << std::endl;
+    int signal;
+    sigwait(&signals, &signal);
+    server.stop();
+    if(trace != nullptr)   Tracer::saveChrome(trace);
+    std::cout << server.getRequests() << " requests" << std::endl;
+    return 0;
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 2;
+  }
+}
@@ -0,0 +1,93 @@
+#include "server.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+// Load generator for rootsd:
+//
+//   rootsload socket [clients] [requests] [degree] [window]
+//
+// Each of clients connections sends requests random polynomials of the degree, keeping
+// up to window of them under way, and times each from its send to its response. Prints the
+// throughput and the percentiles of the latency over all clients.
+
+int main(int argc, char** argv) {
+  if(argc < 2) {
+    std::cerr << "usage: " << argv[0] << " socket [clients] [requests] [degree] [window]" << std::endl;
+    return 2;
+  }
+  std::string path = argv[1];
+  int clients = ((argc > 2) ? std::atoi(argv[2]) : 4);
+  int requests = ((argc > 3) ? std::atoi(argv[3]) : 10000);
+  int degree = ((argc > 4) ? std::atoi(argv[4]) : 12);
+  int window = ((argc > 5) ? std::atoi(argv[5]) : 16);
+  if(clients < 1 || requests < 1 || degree < 1 || window < 1) {
+    std::cerr << "The counts, the degree and the window must be positive." << std::endl;
+    return 2;
+  }
+
+  typedef std::chrono::steady_clock Clock;
+  std::vector<std::vector<double> > latency(clients);
+  std::vector<int> failed(clients, 0);
+  std::vector<std::string> errors(clients);
+
+  Clock::time_point start = Clock::now();
+  std::vector<std::thread> threads;
+  for(int c=0; c<clients; c++) {
+    threads.push_back(std::thread([&, c]() {
+      try {
+        RootClient client(path);
+        std::mt19937 generator(c + 1);
+        std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+        std::vector<double> coeff(degree + 1);
+        std::map<std::uint32_t, Clock::time_point> sent;
+        RootResult r;
+        int next{0};
+        while((int)latency[c].size() < requests) {
+          while(next < requests && (int)sent.size() < window) {
+            for(int j=0; j<=degree; j++) coeff[j] = uniform(generator);
+            coeff[0] = 1.0;
+            sent[next] = Clock::now();
+            client.send(next++, coeff);
+          }
+          std::uint32_t id = client.receive(r);
+          latency[c].push_back(std::chrono::duration<double>(Clock::now() - sent[id]).count());
+          sent.erase(id);
+          if(r.status != RootStatus::Success)   failed[c]++;
+        }
+      }
+      catch (const std::exception& e) {
+        errors[c] = e.what();
+      }
+    }));
+  }
+  for(int c=0; c<clients; c++) threads[c].join();
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::vector<double> all;
+  int notSolved{0};
+  for(int c=0; c<clients; c++) {
+    if(!errors[c].empty()) {
+      std::cerr << "client " << c << ": " << errors[c] << std::endl;
+      return 1;
+    }
+    all.insert(all.end(), latency[c].begin(), latency[c].end());
+    notSolved += failed[c];
+  }
+  std::sort(all.begin(), all.end());
+  std::cout << all.size() << " requests in " << seconds << " s, " << all.size()/seconds << " per second, "
+            << notSolved << " not solved" << std::endl;
+  const double percentiles[] = {0.5, 0.9, 0.99, 0.999};
+  for(double p : percentiles) {
+    std::cout << "p" << p*100 << " " << all[std::min(all.size() - 1, (size_t)(p*all.size()))]*1.0e6 << " us" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,186 @@
+#include <Python.h>
+
+#include "akiti.h"
+#include "roots.h"
+#include "batch.h"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <climits>
+#include <stdexcept>
+
+// Python module roots.
+//
+//   find_roots(coeffs) -> (real parts, imaginary parts)
+//       Roots::findRoots with Akiti on one polynomial, leading coefficient first.
+//
+//   solve_batch(coeffs, zr, zi, found=None, threads=0) -> number not solved completely
+//       Solves every row of the 2-D float64 array coeffs, of shape (count, N+1), into the
+//       preallocated float64 arrays zr and zi of shape (count, N) and, if given, the number
+//       of roots found into the int32 array found of length count. The arrays are used in
+//       place through the buffer protocol, as NumPy arrays are, without a copy; they must be
+//       C-contiguous. The GIL is released during the solve, which runs on threads workers,
+//       0 for one per hardware thread. The BatchSolver of each degree and threads is kept for
+//       the later calls, and solves one call at a time.
+
+namespace {
+
+struct Solver {
+  std::mutex lock;
+  std::unique_ptr<BatchSolver> batch;
+};
+
+std::mutex solversLock;
+std::map<std::pair<int, int>, std::shared_ptr<Solver> > solvers;
+
+// The solver kept for the degree and threads, made on first use
+std::shared_ptr<Solver> getSolver(int N, int threads) {
+  std::lock_guard<std::mutex> guard(solversLock);
+  std::shared_ptr<Solver>& s = solvers[std::make_pair(N, threads)];
+  if(!s)   s = std::make_shared<Solver>();
+  return s;
+}
+
+// A C-contiguous buffer of ndim dimensions and the given format; sets a Python exception
+// and returns false otherwise
+bool getBuffer(PyObject* obj, Py_buffer* view, int ndim, const char* format, bool writable, const char* name) {
+  int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+  if(PyObject_GetBuffer(obj, view, flags) != 0) return false;
+  if(view->ndim != ndim || view->format == nullptr || std::string(view->format) != format) {
+    PyErr_Format(PyExc_ValueError, "%s must be a %d-dimensional array of format '%s'.", name, ndim, format);
+    PyBuffer_Release(view);
+    return false;
+  }
+  return true;
+}
+
+PyObject* findRoots(PyObject*, PyObject* args) {
+  PyObject* obj;
+  if(!PyArg_ParseTuple(args, "O", &obj)) return nullptr;
+  PyObject* seq = PySequence_Fast(obj, "coeffs must be a sequence of numbers.");
+  if(seq == nullptr) return nullptr;
+
+  Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+  std::vector<double> coeff(n);
+  for(Py_ssize_t j=0; j<n; j++) coeff[j] = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(seq, j));
+  Py_DECREF(seq);
+  if(PyErr_Occurred()) return nullptr;
+  if(n < 2) {
+    PyErr_SetString(PyExc_ValueError, "coeffs must have at least two coefficients.");
+    return nullptr;
+  }
+
+  int degree;
+  std::vector<double> zr, zi;
+  try {
+    Akiti akiti(n - 1);
+    Roots rootfinder(&akiti);
+    rootfinder.findRoots(coeff);
+    rootfinder.getRoots(degree, zr, zi);
+  }
+  catch (const std::invalid_argument& e) {
+    PyErr_SetString(PyExc_ValueError, e.what());
+    return nullptr;
+  }
+  catch (const std::exception& e) {
+    PyErr_SetString(PyExc_RuntimeError, e.what());
+    return nullptr;
+  }
+
+  PyObject* re = PyList_New(degree);
+  PyObject* im = PyList_New(degree);
+  for(int j=0; j<degree; j++) {
+    PyList_SET_ITEM(re, j, PyFloat_FromDouble(zr[j]));
+    PyList_SET_ITEM(im, j, PyFloat_FromDouble(zi[j]));
+  }
+  return Py_BuildValue("(NN)", re, im);
+}
+
+PyObject* solveBatch(PyObject*, PyObject* args, PyObject* kwargs) {
+  static const char* keywords[] = {"coeffs", "zr", "zi", "found", "threads", nullptr};
+  PyObject *oc, *ozr, *ozi, *ofound = Py_None;
+  int threads{0};
+  if(!PyArg_ParseTupleAndKeywords(args, kwargs, "OOO|Oi", const_cast<char**>(keywords),
+                                  &oc, &ozr, &ozi, &ofound, &threads)) return nullptr;
+
+  Py_buffer c, zr, zi, found;
+  bool hasFound = (ofound != Py_None);
+  if(!getBuffer(oc, &c, 2, "d", false, "coeffs")) return nullptr;
+  if(!getBuffer(ozr, &zr, 2, "d", true, "zr")) {
+    PyBuffer_Release(&c);
+    return nullptr;
+  }
+  if(!getBuffer(ozi, &zi, 2, "d", true, "zi")) {
+    PyBuffer_Release(&c);
+    PyBuffer_Release(&zr);
+    return nullptr;
+  }
+  if(hasFound && !getBuffer(ofound, &found, 1, "i", true, "found")) {
+    PyBuffer_Release(&c);
+    PyBuffer_Release(&zr);
+    PyBuffer_Release(&zi);
+    return nullptr;
+  }
+
+  auto release = [&]() {
+    PyBuffer_Release(&c);
+    PyBuffer_Release(&zr);
+    PyBuffer_Release(&zi);
+    if(hasFound)   PyBuffer_Release(&found);
+  };
+
+  if(c.shape[0] > INT_MAX || c.shape[1] - 1 > INT_MAX) {
+    release();
+    PyErr_SetString(PyExc_ValueError, "coeffs must have at most INT_MAX rows and INT_MAX+1 columns.");
+    return nullptr;
+  }
+  int count = (int)c.shape[0];
+  int N = (int)(c.shape[1] - 1);
+  if(N < 1 || zr.shape[0] != count || zi.shape[0] != count || zr.shape[1] != N || zi.shape[1] != N
+     || (hasFound && found.shape[0] != count)) {
+    release();
+    PyErr_SetString(PyExc_ValueError, "zr and zi must have shape (count, N) for coeffs of shape (count, N+1), and found length count.");
+    return nullptr;
+  }
+
+  int failed{-1};
+  Py_BEGIN_ALLOW_THREADS
+  try {
+    std::shared_ptr<Solver> s = getSolver(N, threads);
+    std::lock_guard<std::mutex> guard(s->lock);
+    if(!s->batch)   s->batch.reset(new BatchSolver(N, threads));
+    failed = s->batch->solve(count, N, (const double*)c.buf, N + 1, (double*)zr.buf, (double*)zi.buf, N,
+                             (hasFound ? (int*)found.buf : nullptr));
+  }
+  catch (const std::exception&) {
+    // Out of memory or threads; reported once the GIL is back
+  }
+  Py_END_ALLOW_THREADS
+
+  release();
+  if(failed < 0)   return PyErr_NoMemory();
+  return PyLong_FromLong(failed);
+}
+
+PyMethodDef methods[] = {
+  {"find_roots", (PyCFunction)findRoots, METH_VARARGS,
+   "find_roots(coeffs) -> (real parts, imaginary parts) of the roots, leading coefficient first."},
+  {"solve_batch", (PyCFunction)(void(*)(void))solveBatch, METH_VARARGS | METH_KEYWORDS,
+   "solve_batch(coeffs, zr, zi, found=None, threads=0) -> number of rows not solved completely."},
+  {nullptr, nullptr, 0, nullptr}
+};
+
+PyModuleDef module = {
+  PyModuleDef_HEAD_INIT, "roots", "Roots of real polynomials by Jenkins-Traub.", -1, methods,
+  nullptr, nullptr, nullptr, nullptr
+};
+
+}
+
+PyMODINIT_FUNC PyInit_roots(void) {
+  return PyModule_Create(&module);
+}
@@ -3,8 +3,11 @@
 #include "rpoly.h"
 #include "rpolystub.h"
 #include "roots.h"
+#include "akiti.h"
 
 #include <vector>
+#include <cmath>
+#include <cstdlib>
 #include <stdexcept>
 
 using namespace testing;
@@ -160,3 +163,325 @@ TEST_F(RootFinder, GetMaximalNegativeRealRoot) {
   ASSERT_THAT(rootfinder.getMaxNegRealRoot(), Eq(-2.0));
 }
 
+
+TEST_F(RootFinder, IndexRootsAnswersRangeQueries) {
+  Roots rootfinder(rpoly10);
+  std::vector<double> coeff = {1,2,3,4,5,6,7,8,9,10};
+  rootfinder.findRoots(coeff);
+  rootfinder.indexRoots();
+
+  std::vector<double> zr, zi;
+  const RootIndex& index = rootfinder.getRootIndex();
+  EXPECT_THAT(index.size(), Eq(9));
+  EXPECT_THAT(index.realRootsIn(-1.5, 1.5, zr), Eq(4));
+  EXPECT_THAT(zr, ElementsAre(-1.0, -0.07, 0.065297428539351, 1.0));
+}
+
+TEST_F(RootFinder, SolveReturnsStatusInsteadOfThrowing) {
+  Roots rootfinder(rpoly01);
+  int found;
+  std::vector<double> coeff = {1.0, 2.0, 3.0};
+  EXPECT_TRUE(rootfinder.solve(coeff, found) == RootStatus::DegreeTooLarge);
+  coeff = {0.0, 1.0};
+  EXPECT_TRUE(rootfinder.solve(coeff, found) == RootStatus::LeadingCoefficientZero);
+  EXPECT_THAT(found, Eq(0));
+}
+
+TEST_F(RootFinder, SolveKeepsRunningAfterFailureToConverge) {
+  Roots rootfinder(rpoly10);
+  int found;
+  std::vector<double> coeff = {1,2,3,4,5,6,7,8,9};
+  EXPECT_TRUE(rootfinder.solve(coeff, found) == RootStatus::NoConvergence);
+  EXPECT_THAT(found, Eq(0));
+
+  coeff = {1,2,3,4,5,6,7,8,9,10};
+  EXPECT_TRUE(rootfinder.solve(coeff, found) == RootStatus::Success);
+  EXPECT_THAT(found, Eq(9));
+  EXPECT_THAT(rootfinder.getMaxPosRealRoot(), Eq(2.0));
+}
+
+TEST_F(RootFinder, HurwitzStabilityWithoutSolving) {
+  Roots rootfinder(rpoly10);
+  // (s+1)(s+2)(s+3)
+  EXPECT_TRUE(rootfinder.isHurwitzStable({1, 6, 11, 6}));
+  EXPECT_TRUE(rootfinder.isHurwitzStable({-1, -6, -11, -6}));
+  // (s-1)(s+2)(s+3)
+  EXPECT_FALSE(rootfinder.isHurwitzStable({1, 4, 1, -6}));
+  // s^3 + s^2 + 2s + 8 = (s+2)(s^2 - s + 4): positive coefficients, two unstable roots
+  EXPECT_FALSE(rootfinder.isHurwitzStable({1, 1, 2, 8}));
+  EXPECT_TRUE(rootfinder.isHurwitzStable({5}));
+}
+
+TEST_F(RootFinder, HurwitzSingularCasesAreNotStable) {
+  Roots rootfinder(rpoly10);
+  // (s+1)(s^2+1): a Routh row vanishes for the roots on the imaginary axis
+  EXPECT_FALSE(rootfinder.isHurwitzStable({1, 1, 1, 1}));
+  // s^4 + s^3 + 2s^2 + 2s + 3: a zero first element, two roots in the right half-plane
+  EXPECT_FALSE(rootfinder.isHurwitzStable({1, 1, 2, 2, 3}));
+  // Root at the origin
+  EXPECT_FALSE(rootfinder.isHurwitzStable({1, 3, 2, 0}));
+}
+
+TEST_F(RootFinder, SchurStabilityWithoutSolving) {
+  Roots rootfinder(rpoly10);
+  // (z-0.5)(z+0.25)(z-0.9)
+  EXPECT_TRUE(rootfinder.isSchurStable({1, -1.15, 0.225, 0.1125}));
+  // (z-0.5)(z-1.1)
+  EXPECT_FALSE(rootfinder.isSchurStable({1, -1.6, 0.55}));
+  // z^2 + 0.5z + 0.9: complex pair of modulus sqrt(0.9)
+  EXPECT_TRUE(rootfinder.isSchurStable({1, 0.5, 0.9}));
+  // (z-2)(z-0.5) = z^2 - 2.5z + 1: the pair z, 1/z makes |gamma| = 1
+  EXPECT_FALSE(rootfinder.isSchurStable({1, -2.5, 1}));
+  // (z-1)(z-0.5): root on the unit circle
+  EXPECT_FALSE(rootfinder.isSchurStable({1, -1.5, 0.5}));
+}
+
+TEST_F(RootFinder, StabilityOfLeadingCoefficientZeroThrows) {
+  Roots rootfinder(rpoly10);
+  try {
+    rootfinder.isHurwitzStable({0, 1, 1});
+    FAIL() << "Expected std::invalid_argument";
+  }
+  catch (const std::invalid_argument& expected) {
+    ASSERT_STREQ(expected.what(), "The leading coefficient is zero.");
+  }
+}
+
+TEST_F(RootFinder, BatchStabilityAgreesWithSingleTests) {
+  Stability stability;
+  int count = 37, N = 5;
+  std::vector<double> c((N + 1)*count);
+  std::vector<std::vector<double> > polys(count, std::vector<double>(N + 1));
+  for(int s=0; s<count; s++) {
+    for(int j=0; j<=N; j++) {
+      polys[s][j] = (j == 0) ? 1.0 : (double)(((s + 3)*(j + 5)*7) % 13)/(4.0 + j);
+      c[j*count + s] = polys[s][j];
+    }
+  }
+  // A singular case of each kind
+  std::vector<double> axis = {1, 1, 1, 1, 0, 0}, circle = {1, -1, 0, 0, 0, 0};
+  for(int j=0; j<=N; j++) {
+    polys[0][j] = c[j*count] = axis[j];
+    polys[1][j] = c[j*count + 1] = circle[j];
+  }
+
+  bool h[37], z[37];
+  stability.hurwitz(count, N, c.data(), h);
+  stability.schur(count, N, c.data(), z);
+  int nHurwitz = 0, nSchur = 0;
+  for(int s=0; s<count; s++) {
+    EXPECT_THAT(h[s], Eq(stability.hurwitz(polys[s])));
+    EXPECT_THAT(z[s], Eq(stability.schur(polys[s])));
+    nHurwitz += h[s];
+    nSchur += z[s];
+  }
+  EXPECT_FALSE(h[0]);
+  EXPECT_FALSE(z[1]);
+  EXPECT_THAT(nHurwitz + nSchur, Gt(0));
+}
+
+TEST_F(RootFinder, CountRealRootsInInterval) {
+  Roots rootfinder(rpoly10);
+  // (x-1)(x-2)(x-3)(x-4)
+  std::vector<double> coeff = {1, -10, 35, -50, 24};
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, 0.0, 5.0), Eq(4));
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, 1.5, 3.5), Eq(2));
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, 1.0, 2.0), Eq(2));
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, 2.5, 2.7), Eq(0));
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, 3.0, 3.0), Eq(1));
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, 5.0, 0.0), Eq(0));
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, -HUGE_VAL, HUGE_VAL), Eq(4));
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, 3.5, 1.0e300), Eq(1));
+}
+
+TEST_F(RootFinder, CountRealRootsCountsMultipleRootsOnce) {
+  Roots rootfinder(rpoly10);
+  // (x-1)^2 (x+1)
+  std::vector<double> coeff = {1, -1, -1, 1};
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, -2.0, 2.0), Eq(2));
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, 0.5, 1.5), Eq(1));
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, 1.0, 1.5), Eq(1));
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, -0.5, 0.5), Eq(0));
+
+  // x^4 + 1 has no real roots; switching polynomials rebuilds the chain
+  EXPECT_THAT(rootfinder.countRealRoots({1, 0, 0, 0, 1}, -HUGE_VAL, HUGE_VAL), Eq(0));
+  EXPECT_THAT(rootfinder.countRealRoots(coeff, -HUGE_VAL, HUGE_VAL), Eq(2));
+}
+
+TEST_F(RootFinder, CountRealRootsOfWilkinsonPolynomial) {
+  Roots rootfinder(rpoly10);
+  std::vector<double> coeff(1, 1.0);
+  for(int k=1; k<=10; k++) {
+    std::vector<double> next(coeff.size() + 1, 0.0);
+    for(size_t i=0; i<coeff.size(); i++) {
+      next[i] += coeff[i];
+      next[i + 1] -= k*coeff[i];
+    }
+    coeff = next;
+  }
+  for(int k=0; k<=10; k++) {
+    EXPECT_THAT(rootfinder.countRealRoots(coeff, 0.5, k + 0.5), Eq(k));
+  }
+}
+
+TEST_F(RootFinder, BezierRootsInUnitInterval) {
+  Roots rootfinder(rpoly10);
+  // 8t^3 - 22t^2 + 13t - 2 = 8 (t-1/4)(t-1/2)(t-2) in Bernstein form: only 1/4 and 1/2
+  // lie in [0, 1]
+  std::vector<double> b = {-2.0, 7.0/3.0, -2.0/3.0, -3.0};
+  std::vector<double> t;
+  rootfinder.findBezierRoots(b, t);
+  EXPECT_THAT(t, ElementsAre(DoubleNear(0.25, 1e-14), DoubleNear(0.5, 1e-14)));
+}
+
+TEST_F(RootFinder, BezierRootsAtEndPointsAndDoubleRoot) {
+  Roots rootfinder(rpoly10);
+  std::vector<double> t;
+  // t (1-t): zero at both end points
+  rootfinder.findBezierRoots({0.0, 0.5, 0.0}, t);
+  EXPECT_THAT(t, ElementsAre(Eq(0.0), Eq(1.0)));
+  // (2t-1)^2 touches the axis at 1/2 and is reported once
+  rootfinder.findBezierRoots({1.0, -1.0, 1.0}, t);
+  EXPECT_THAT(t, ElementsAre(DoubleNear(0.5, 1e-7)));
+  rootfinder.findBezierRoots({1.0, 0.5, 2.0}, t);
+  EXPECT_TRUE(t.empty());
+  // (1-t)^2 + t^2 has a control point on the axis but stays above 1/2
+  rootfinder.findBezierRoots({1.0, 0.0, 1.0}, t);
+  EXPECT_TRUE(t.empty());
+  rootfinder.findBezierRoots({1.0, 1e-17, 1.0}, t);
+  EXPECT_TRUE(t.empty());
+
+  BezierRoots bezier;
+  std::vector<int> first;
+  std::vector<double> b = {1.0, 1.0, 0.0, 1e-17, 1.0, 1.0};
+  bezier.find(2, 2, b.data(), first, t);
+  EXPECT_THAT(first, ElementsAre(0, 0, 0));
+  EXPECT_TRUE(t.empty());
+}
+
+TEST_F(RootFinder, BatchBezierRootsAgreeWithSingleSegments) {
+  int count = 101, n = 3;
+  std::vector<double> b((n + 1)*count);
+  srand(5);
+  for(int s=0; s<count; s++) {
+    for(int i=0; i<=n; i++) b[i*count + s] = rand()/(double)RAND_MAX - 0.3;
+  }
+
+  BezierRoots bezier;
+  std::vector<int> first;
+  std::vector<double> t, single;
+  bezier.find(count, n, b.data(), first, t);
+  ASSERT_THAT(first.size(), Eq((size_t)count + 1));
+  int crossing{0};
+  for(int s=0; s<count; s++) {
+    std::vector<double> c(n + 1);
+    for(int i=0; i<=n; i++) c[i] = b[i*count + s];
+    bezier.find(c, single);
+    ASSERT_THAT(first[s + 1] - first[s], Eq((int)single.size()));
+    for(size_t k=0; k<single.size(); k++) EXPECT_THAT(t[first[s] + k], Eq(single[k]));
+    if(!single.empty()) crossing++;
+  }
+  EXPECT_THAT(crossing, Gt(0));
+}
+
+TEST_F(RootFinder, ChebyshevRootsOfChebyshevPolynomial) {
+  Roots rootfinder(rpoly10);
+  // T_200, whose roots are the Chebyshev points cos((k - 1/2) pi/200)
+  int n = 200;
+  std::vector<double> c(n + 1, 0.0), x;
+  c[n] = 1.0;
+  rootfinder.findChebyshevRoots(c, x);
+  ASSERT_THAT(x.size(), Eq((size_t)n));
+  const double pi = 3.14159265358979323846;
+  for(int k=0; k<n; k++) {
+    EXPECT_THAT(x[k], DoubleNear(cos((n - k - 0.5)*pi/n), 1e-14));
+  }
+}
+
+TEST_F(RootFinder, ChebyshevRootsOfSmoothFunctionByPieces) {
+  // sin(60x + 0.3) resolved to rounding level by degree 120, whose roots in [-1, 1] are
+  // (j pi - 0.3)/60 for j = -19 ... 19
+  int n = 120, M = n + 1;
+  const double pi = 3.14159265358979323846;
+  std::vector<double> f(M), c(M), x;
+  for(int j=0; j<M; j++) f[j] = sin(60.0*cos(pi*(j + 0.5)/M) + 0.3);
+  for(int k=0; k<M; k++) {
+    double s{0.0};
+    for(int j=0; j<M; j++) s += f[j]*cos(pi*k*(j + 0.5)/M);
+    c[k] = ((k == 0) ? 1.0 : 2.0)*s/M;
+  }
+
+  ChebyshevRoots chebyshev(30);
+  Akiti akiti(32);
+  chebyshev.find(c, akiti, x);
+  ASSERT_THAT(x.size(), Eq((size_t)39));
+  for(int j=-19; j<=19; j++) {
+    EXPECT_THAT(x[j + 19], DoubleNear((j*pi - 0.3)/60.0, 1e-13));
+  }
+}
+
+TEST_F(RootFinder, ChebyshevRootsOfNearTangentFunction) {
+  // cos(40x + 0.1) - (1 - 1e-8) has pairs of roots 7e-6 apart at (2 pi j - 0.1 +- d)/40,
+  // d = acos(1 - 1e-8), for j = -6 ... 6, each pair within one piece
+  int n = 160, M = n + 1;
+  const double pi = 3.14159265358979323846;
+  std::vector<double> f(M), c(M), x;
+  for(int j=0; j<M; j++) f[j] = cos(40.0*cos(pi*(j + 0.5)/M) + 0.1) - (1.0 - 1e-8);
+  for(int k=0; k<M; k++) {
+    double s{0.0};
+    for(int j=0; j<M; j++) s += f[j]*cos(pi*k*(j + 0.5)/M);
+    c[k] = ((k == 0) ? 1.0 : 2.0)*s/M;
+  }
+
+  ChebyshevRoots chebyshev;
+  Akiti akiti(32);
+  chebyshev.find(c, akiti, x);
+  ASSERT_THAT(x.size(), Eq((size_t)26));
+  double d = acos(1.0 - 1e-8);
+  for(int j=-6; j<=6; j++) {
+    EXPECT_THAT(x[2*(j + 6)], DoubleNear((2.0*j*pi - 0.1 - d)/40.0, 1e-10));
+    EXPECT_THAT(x[2*(j + 6) + 1], DoubleNear((2.0*j*pi - 0.1 + d)/40.0, 1e-10));
+  }
+}
+
+TEST_F(RootFinder, ChebyshevRootsOfRandomExpansionAreItsSignChanges) {
+  // Coefficients without decay, whose roots fill [-1, 1], through hundreds of pieces
+  int n = 300;
+  std::vector<double> c(n + 1), x;
+  for(int k=0; k<=n; k++) c[k] = cos(0.7*k*k);
+
+  ChebyshevRoots chebyshev;
+  Akiti akiti(32);
+  chebyshev.find(c, akiti, x);
+  int changes{0};
+  double last = chebyshev.evaluate(c, -1.0);
+  for(int j=1; j<=200000; j++) {
+    double p = chebyshev.evaluate(c, -1.0 + j*1e-5);
+    if((p < 0.0) != (last < 0.0)) changes++;
+    last = p;
+  }
+  ASSERT_THAT(x.size(), Eq((size_t)changes));
+  for(size_t k=0; k<x.size(); k++) {
+    EXPECT_THAT(fabs(chebyshev.evaluate(c, x[k])), Lt(1e-11));
+  }
+
+  // Without a solver every piece goes to its colleague matrix
+  std::vector<double> y;
+  chebyshev.find(c, y);
+  ASSERT_THAT(y.size(), Eq(x.size()));
+  for(size_t k=0; k<y.size(); k++) {
+    EXPECT_THAT(y[k], DoubleNear(x[k], 1e-12));
+  }
+}
+
+TEST_F(RootFinder, ChebyshevRootsOfZeroExpansionThrow) {
+  Roots rootfinder(rpoly10);
+  std::vector<double> x;
+  try {
+    rootfinder.findChebyshevRoots({0.0, 0.0, 0.0}, x);
+    FAIL() << "Expected std::invalid_argument";
+  }
+  catch (const std::invalid_argument& expected) {
+    ASSERT_STREQ(expected.what(), "The Chebyshev expansion is zero.");
+  }
+}
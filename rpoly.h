@@ -1,17 +1,108 @@
+#include "sparse.h"
+
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
 #ifndef RPoly_h
 #define RPoly_h
 
+// Outcome of the exception-free solve
+enum class RootStatus {
+  Success,
+  DegreeTooLarge,
+  LeadingCoefficientZero,
+  NoConvergence
+};
+
 class RPoly {
   public:
     int maxDegree;
     int mdp1;
-    RPoly(int maxDeg) : maxDegree(maxDeg), mdp1(maxDeg+1) {};
+    // Requested accuracy of the roots: iterations may stop once a root is known to within
+    // atol + rtol*|z|. Zero for both asks for full precision.
+    double rtol;
+    double atol;
+    RPoly(int maxDeg) : maxDegree(maxDeg), mdp1(maxDeg+1), rtol(0.0), atol(0.0) {};
     virtual ~RPoly(void) {};
     virtual void initialize() = 0;
+    // Label of the solver in traces and metrics
+    virtual const char* name(void) const { return "rpoly"; };
+    virtual void setAccuracy(double rtol, double atol) {
+      this->rtol = rtol;
+      this->atol = atol;
+    };
     // rpoly must check degree less than or equal to maxDegree
     // rpoly must check leading coefficient is not zero
     virtual void rpoly(double* op, int degree, double* zeror, double* zeroi) = 0;
+    // Sparse input. The default densifies into op, of length mdp1, and calls rpoly;
+    // solvers that iterate on the terms directly override it.
+    virtual void rpolySparse(const SparsePoly& poly, double* op, double* zeror, double* zeroi) {
+      if (poly.degree() > maxDegree){
+        throw std::invalid_argument( "Requested maximal degree is greater than MAXDEGREE." );
+      }
+      poly.densify(op);
+      rpoly(op, poly.degree(), zeror, zeroi);
+    };
+    // Exception-free rpoly. On return zeror, zeroi hold the first *found roots, all of them
+    // on success. The default checks the arguments and wraps rpoly, so it reports no partial
+    // roots; solvers that can stop without unwinding override it.
+    virtual RootStatus solve(double* op, int degree, double* zeror, double* zeroi, int* found) noexcept {
+      *found = 0;
+      if (degree > maxDegree)   return RootStatus::DegreeTooLarge;
+      if (op[0] == 0.0)         return RootStatus::LeadingCoefficientZero;
+      try {
+        rpoly(op, degree, zeror, zeroi);
+      }
+      catch (...) {
+        return RootStatus::NoConvergence;
+      }
+      *found = degree;
+      return RootStatus::Success;
+    };
+    // Lazy solve. begin checks the arguments and starts a solve of op; each next stores one
+    // or two further roots after the *found already in zeror, zeroi and advances *found,
+    // until *found == degree or a failure to converge. The default solves completely in
+    // begin and hands out the roots one at a time in order of increasing modulus; solvers
+    // that deflate find them on demand instead.
+    virtual RootStatus begin(double* op, int degree, double* zeror, double* zeroi) noexcept {
+      lazyDegree = lazyEnd = 0;
+      int n;
+      RootStatus status = solve(op, degree, zeror, zeroi, &n);
+      if (status == RootStatus::DegreeTooLarge || status == RootStatus::LeadingCoefficientZero)   return status;
+
+      try {
+        std::vector<int> order(n);
+        std::vector<double> zr(zeror, zeror + n), zi(zeroi, zeroi + n);
+        for (int i = 0; i < n; i++)   order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b){
+          return std::hypot(zr[a], zi[a]) < std::hypot(zr[b], zi[b]);
+        });
+        for (int i = 0; i < n; i++){
+          zeror[i] = zr[order[i]];
+          zeroi[i] = zi[order[i]];
+        }
+      }
+      catch (...) {
+        // Out of memory: hand the roots out in the order found
+      }
+      lazyDegree = degree;
+      lazyEnd = n;
+      return RootStatus::Success;
+    };
+    virtual RootStatus next(int* found) noexcept {
+      if (*found < lazyEnd){
+        (*found)++;
+        return RootStatus::Success;
+      }
+      return ((lazyEnd < lazyDegree) ? RootStatus::NoConvergence : RootStatus::Success);
+    };
+
+  private:
+    // Roots of the default lazy solve: lazyEnd of lazyDegree were found
+    int lazyDegree{0};
+    int lazyEnd{0};
 };
 
 #endif
-
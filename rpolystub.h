@@ -12,19 +12,20 @@ class RPolyStub: public RPoly {
     ~RPolyStub(void);
 
     void initialize() override;
+    const char* name(void) const override { return "stub"; };
     void rpoly(double* op, int Degree, double* zeror, double* zeroi) override;
 };
 
-RPolyStub::RPolyStub(int degree): RPoly(degree) {
+inline RPolyStub::RPolyStub(int degree): RPoly(degree) {
   maxDegree = degree;
   mdp1 = degree+1;
 }
 
-RPolyStub::~RPolyStub(void) {}
+inline RPolyStub::~RPolyStub(void) {}
 
-void RPolyStub::initialize() {}
+inline void RPolyStub::initialize() {}
 
-void RPolyStub::rpoly(double* op, int Degree, double* zeror, double* zeroi) {
+inline void RPolyStub::rpoly(double* op, int Degree, double* zeror, double* zeroi) {
   if (Degree > maxDegree){
     throw std::invalid_argument( "Requested maximal degree is greater than MAXDEGREE." );
   }
@@ -33,6 +34,10 @@ void RPolyStub::rpoly(double* op, int Degree, double* zeror, double* zeroi) {
     throw std::invalid_argument( "The leading coefficient is zero." );
   }
 
+  if (Degree == 8) {
+    throw std::runtime_error( "Failure to converge after 20 shifts." );
+  }
+
   if (Degree == 9) {
     zeror[0] = 0.065297428539351;
     zeror[1] =-1.0;
@@ -72,3 +72,19 @@ TEST_F(RpolyInterface, ExceptionThrownForExceedingMaximalDegree) {
   }
 }
 
+
+TEST_F(RpolyInterface, SolveReportsInvalidArgumentsAsStatus) {
+  int found;
+  op[0] = 0.0;
+  EXPECT_TRUE(rpoly->solve(op,DEGREE,zr,zi,&found) == RootStatus::LeadingCoefficientZero);
+  op[0] = 1.0;
+  EXPECT_TRUE(rpoly->solve(op,DEGREE+1,zr,zi,&found) == RootStatus::DegreeTooLarge);
+  EXPECT_THAT(found, Eq(0));
+}
+
+TEST_F(RpolyInterface, SolveReportsFailureToConvergeAsStatus) {
+  int found;
+  op[0] = 1.0;
+  EXPECT_TRUE(rpoly->solve(op,8,zr,zi,&found) == RootStatus::NoConvergence);
+  EXPECT_THAT(found, Eq(0));
+}
@@ -0,0 +1,271 @@
+#include "akiti.h"
+#include "roots.h"
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+#ifndef StealingSolver_h
+#define StealingSolver_h
+
+// Cost of solving a polynomial of degree n, learned from the solves themselves.
+//
+// Jenkins-Traub takes a number of fixed and variable shift steps for each root, each
+// step O(n), and a deflation, O(n), so the work is about n*(n*s + n) for s steps per root.
+// The model keeps s, the mean of the steps and iterations Akiti counts per root, for each
+// range of degrees [2^b, 2^(b+1)), and the time per unit of that work, each as a moving
+// average over the solves. predict gives seconds; only the ratios matter to the schedule.
+
+class CostModel {
+  public:
+    CostModel(void);
+    double predict(int n) const;
+    void record(int n, int steps, double seconds);
+    double getStepsPerRoot(int n) const;
+
+  private:
+    static const int Buckets = 20;
+    // Weight of a new observation in the moving averages
+    static constexpr double Weight = 0.05;
+
+    double stepsPerRoot[Buckets];
+    double secondsPerUnit;
+
+    int bucket(int n) const;
+    double units(int n, double s) const;
+};
+
+// Solves a batch of polynomials of mixed degrees on threads that steal work from each
+// other.
+//
+// plan orders the polynomials by predicted cost, largest first. Those that cost more than
+// a share of the batch, a total over 8 chunks per thread, go alone; the small ones are
+// packed into chunks of about that cost. The chunks are dealt, largest first, to the
+// thread with the least predicted work, and each thread works through its own deque from
+// the front. A thread whose deque is empty steals from the back of another, where the
+// smallest chunks are, so the predicted large polynomials start first and mistakes of the
+// model are evened out by the small work at the end.
+//
+// Each thread has its own Akiti and Roots, kept between batches. The degree, the steps of
+// Akiti and the time of every solve go into the cost model after the batch, so the
+// schedule of the next batch uses them.
+
+class StealingSolver {
+  public:
+    StealingSolver(int maxDegree, int threads = 0);
+    ~StealingSolver(void);
+    int solve(const std::vector<std::vector<double> >& polys, std::vector<RootResult>& results);
+    void plan(const std::vector<std::vector<double> >& polys, std::vector<std::vector<int> >& chunks) const;
+    const CostModel& getCostModel(void) const;
+    int getThreads(void) const;
+    int getSteals(void) const;
+
+  private:
+    struct Sample {
+      int n;
+      int steps;
+      double seconds;
+    };
+
+    struct Worker {
+      Akiti* akiti;
+      Roots* roots;
+      std::mutex lock;
+      std::deque<int> chunks;
+      std::vector<Sample> samples;
+    };
+
+    int maxDegree;
+    std::vector<Worker*> workers;
+    CostModel model;
+    std::atomic<int> steals{0};
+
+    static const int ChunksPerThread = 8;
+
+    bool take(int t, int& chunk);
+    void run(int t, const std::vector<std::vector<double> >& polys, const std::vector<std::vector<int> >& chunks,
+             std::vector<RootResult>& results, std::atomic<int>& failed);
+};
+
+inline CostModel::CostModel(void) : secondsPerUnit(1.0e-9) {
+  // About ten steps per root for random polynomials of any degree, until measured
+  for(int b=0; b<Buckets; b++) stepsPerRoot[b] = 10.0;
+}
+
+inline int CostModel::bucket(int n) const {
+  int b{0};
+  for(; n > 1 && b < Buckets - 1; n >>= 1) b++;
+  return b;
+}
+
+inline double CostModel::units(int n, double s) const {
+  return (double)n*n*(s + 1.0);
+}
+
+inline double CostModel::getStepsPerRoot(int n) const {
+  return stepsPerRoot[bucket(n)];
+}
+
+inline double CostModel::predict(int n) const {
+  return secondsPerUnit*units(n, stepsPerRoot[bucket(n)]);
+}
+
+inline void CostModel::record(int n, int steps, double seconds) {
+  if(n < 1) return;
+  double s = (double)steps/n;
+  double& mean = stepsPerRoot[bucket(n)];
+  mean += Weight*(s - mean);
+  if(seconds > 0.0) secondsPerUnit += Weight*(seconds/units(n, s) - secondsPerUnit);
+}
+
+inline StealingSolver::StealingSolver(int maxDegree, int threads) : maxDegree(maxDegree) {
+  if(threads <= 0)   threads = std::thread::hardware_concurrency();
+  if(threads <= 0)   threads = 1;
+  for(int t=0; t<threads; t++) {
+    Worker* w = new Worker;
+    w->akiti = new Akiti(maxDegree);
+    w->roots = new Roots(w->akiti);
+    workers.push_back(w);
+  }
+}
+
+inline StealingSolver::~StealingSolver(void) {
+  for(size_t t=0; t<workers.size(); t++) {
+    delete workers[t]->roots;
+    delete workers[t]->akiti;
+    delete workers[t];
+  }
+}
+
+inline const CostModel& StealingSolver::getCostModel(void) const {
+  return model;
+}
+
+inline int StealingSolver::getThreads(void) const {
+  return workers.size();
+}
+
+// Steals in the last batch
+inline int StealingSolver::getSteals(void) const {
+  return steals;
+}
+
+// Chunks of indices into polys, in decreasing order of predicted cost
+inline void StealingSolver::plan(const std::vector<std::vector<double> >& polys,
+                                 std::vector<std::vector<int> >& chunks) const {
+  int m = polys.size();
+  std::vector<double> cost(m);
+  double total{0.0};
+  for(int j=0; j<m; j++) {
+    cost[j] = model.predict(polys[j].size() - 1);
+    total += cost[j];
+  }
+  std::vector<int> order(m);
+  for(int j=0; j<m; j++) order[j] = j;
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return cost[a] > cost[b]; });
+
+  double share = total/(ChunksPerThread*workers.size());
+  chunks.clear();
+  double sum{0.0};
+  for(int j=0; j<m; j++) {
+    if(chunks.empty() || sum >= share) {
+      chunks.push_back(std::vector<int>());
+      sum = 0.0;
+    }
+    chunks.back().push_back(order[j]);
+    sum += cost[order[j]];
+  }
+}
+
+// The next chunk for thread t: its own front, else the back of another thread's deque
+inline bool StealingSolver::take(int t, int& chunk) {
+  {
+    std::lock_guard<std::mutex> guard(workers[t]->lock);
+    if(!workers[t]->chunks.empty()) {
+      chunk = workers[t]->chunks.front();
+      workers[t]->chunks.pop_front();
+      return true;
+    }
+  }
+  int T = workers.size();
+  for(int k=1; k<T; k++) {
+    Worker* victim = workers[(t + k) % T];
+    std::lock_guard<std::mutex> guard(victim->lock);
+    if(!victim->chunks.empty()) {
+      chunk = victim->chunks.back();
+      victim->chunks.pop_back();
+      steals++;
+      return true;
+    }
+  }
+  return false;
+}
+
+inline void StealingSolver::run(int t, const std::vector<std::vector<double> >& polys,
+                                const std::vector<std::vector<int> >& chunks, std::vector<RootResult>& results,
+                                std::atomic<int>& failed) {
+  Worker* w = workers[t];
+  int chunk;
+  while(take(t, chunk)) {
+    for(size_t k=0; k<chunks[chunk].size(); k++) {
+      int j = chunks[chunk][k];
+      RootResult& r = results[j];
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      r.status = w->roots->solve(polys[j], r.found);
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      w->roots->getFoundRoots(r.zr, r.zi);
+      if(r.status != RootStatus::Success)   failed++;
+      else w->samples.push_back(Sample{(int)polys[j].size() - 1, w->akiti->getStepCount() + w->akiti->getIterationCount(), seconds});
+    }
+  }
+}
+
+// Returns the number of polynomials not solved completely
+inline int StealingSolver::solve(const std::vector<std::vector<double> >& polys, std::vector<RootResult>& results) {
+  for(size_t j=0; j<polys.size(); j++) {
+    if(polys[j].size() < 2) {
+      throw std::invalid_argument( "A polynomial needs at least two coefficients." );
+    }
+  }
+  results.assign(polys.size(), RootResult());
+  steals = 0;
+
+  std::vector<std::vector<int> > chunks;
+  plan(polys, chunks);
+
+  // Largest first, each to the thread with the least predicted work so far
+  int T = workers.size();
+  std::vector<double> load(T, 0.0);
+  for(size_t c=0; c<chunks.size(); c++) {
+    double cost{0.0};
+    for(size_t k=0; k<chunks[c].size(); k++) cost += model.predict(polys[chunks[c][k]].size() - 1);
+    int t = std::min_element(load.begin(), load.end()) - load.begin();
+    load[t] += cost;
+    workers[t]->chunks.push_back(c);
+  }
+
+  std::atomic<int> failed{0};
+  std::vector<std::thread> threads;
+  for(int t=1; t<T && t<(int)chunks.size(); t++) {
+    threads.push_back(std::thread(&StealingSolver::run, this, t, std::cref(polys), std::cref(chunks),
+                                  std::ref(results), std::ref(failed)));
+  }
+  run(0, polys, chunks, results, failed);
+  for(size_t t=0; t<threads.size(); t++) threads[t].join();
+
+  for(int t=0; t<T; t++) {
+    for(size_t k=0; k<workers[t]->samples.size(); k++) {
+      const Sample& s = workers[t]->samples[k];
+      model.record(s.n, s.steps, s.seconds);
+    }
+    workers[t]->samples.clear();
+  }
+  return failed;
+}
+
+#endif
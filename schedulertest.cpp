@@ -0,0 +1,84 @@
+#include "gmock/gmock.h"
+
+#include "scheduler.h"
+#include "akiti.h"
+#include "roots.h"
+
+#include <vector>
+#include <random>
+#include <stdexcept>
+
+using namespace testing;
+
+class Scheduler: public Test {
+  public:
+    std::mt19937 rng{11};
+
+    std::vector<double> random(int n) {
+      std::uniform_real_distribution<double> u(-1.0, 1.0);
+      std::vector<double> c(n + 1);
+      for(int j=0; j<=n; j++) c[j] = u(rng);
+      return c;
+    }
+};
+
+TEST_F(Scheduler, MixedBatchGivesTheRootsOfRoots) {
+  std::vector<std::vector<double> > polys;
+  int degrees[] = {3, 150, 4, 5, 80, 3, 200, 7, 3, 40, 6, 3};
+  for(int n : degrees) polys.push_back(random(n));
+
+  StealingSolver solver(200, 3);
+  std::vector<RootResult> results;
+  ASSERT_THAT(solver.solve(polys, results), Eq(0));
+  ASSERT_THAT(results.size(), Eq(polys.size()));
+
+  Akiti akiti(200);
+  Roots rootfinder(&akiti);
+  for(size_t j=0; j<polys.size(); j++) {
+    int degree = polys[j].size() - 1;
+    std::vector<double> zr, zi;
+    rootfinder.findRoots(polys[j]);
+    rootfinder.getFoundRoots(zr, zi);
+    ASSERT_THAT(results[j].found, Eq(degree));
+    for(int i=0; i<degree; i++) {
+      ASSERT_THAT(results[j].zr[i], Eq(zr[i]));
+      ASSERT_THAT(results[j].zi[i], Eq(zi[i]));
+    }
+  }
+}
+
+TEST_F(Scheduler, PlanPutsLargePolynomialsFirstAndPacksSmallOnes) {
+  std::vector<std::vector<double> > polys;
+  for(int j=0; j<200; j++) polys.push_back(random(3));
+  for(int j=0; j<4; j++) polys.push_back(random(300));
+
+  StealingSolver solver(300, 2);
+  std::vector<std::vector<int> > chunks;
+  solver.plan(polys, chunks);
+
+  std::vector<int> seen(polys.size(), 0);
+  for(size_t c=0; c<chunks.size(); c++) {
+    for(int j : chunks[c]) seen[j]++;
+  }
+  ASSERT_THAT(seen, Each(Eq(1)));
+  for(int c=0; c<4; c++) {
+    ASSERT_THAT(chunks[c].size(), Eq(1u));
+    ASSERT_THAT(chunks[c][0], Ge(200));
+  }
+  ASSERT_THAT(chunks.size(), Lt(20u));
+  ASSERT_THAT(chunks.back().size(), Gt(1u));
+}
+
+TEST_F(Scheduler, CostModelLearnsFromTheSolves) {
+  std::vector<std::vector<double> > polys;
+  for(int j=0; j<40; j++) polys.push_back(random(j % 2 ? 5 : 100));
+
+  StealingSolver solver(100, 2);
+  std::vector<RootResult> results;
+  double before = solver.getCostModel().getStepsPerRoot(100);
+  solver.solve(polys, results);
+  ASSERT_THAT(solver.getCostModel().getStepsPerRoot(100), Ne(before));
+  ASSERT_THAT(solver.getCostModel().predict(100), Gt(100.0*solver.getCostModel().predict(5)));
+  ASSERT_THROW(solver.solve(std::vector<std::vector<double> >(1, std::vector<double>(1, 1.0)), results),
+               std::invalid_argument);
+}
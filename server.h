@@ -0,0 +1,480 @@
+#include "async.h"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#ifndef RootServer_h
+#define RootServer_h
+
+// Frames of the protocol between RootServer and RootClient, in the byte order of the host,
+// which both sides of a Unix domain socket share.
+//
+// A request is a RequestFrame followed by the degree+1 coefficients, leading one first.
+// A response is a ResponseFrame followed by found real parts and found imaginary parts.
+// Responses carry the id of their request and come back in the order the solves finish,
+// so a client may have many requests under way on one connection.
+struct RequestFrame {
+  std::uint32_t magic;
+  std::uint32_t id;
+  std::uint32_t degree;
+  std::uint32_t reserved;
+};
+
+struct ResponseFrame {
+  std::uint32_t magic;
+  std::uint32_t id;
+  std::int32_t status;
+  std::uint32_t found;
+};
+
+// 'RTS1' and 'RTR1'
+static const std::uint32_t RequestMagic = 0x31535452;
+static const std::uint32_t ResponseMagic = 0x31525452;
+
+// A long-lived solver behind a Unix domain socket, so that short-lived tools share one
+// pool of warm solvers instead of each starting its own.
+//
+// One thread polls the listening socket and every connection, and hands each complete
+// request to an AsyncRoots, whose workers take the requests of all connections off one
+// queue in batches. A worker never writes to a socket: it appends the response to the
+// queue of its connection and wakes the polling thread, which writes what the client
+// takes whenever its socket has room. A client that does not read its responses stops
+// being read once more than MaxPending bytes of them wait, or MaxSolving of its requests
+// are in the pool, so that it holds up neither the other clients nor the memory of the
+// server. A connection is closed on a malformed frame; a degree above maxDegree gets
+// DegreeTooLarge, and its coefficients are skipped as they come instead of being kept.
+// The connection stays open until its last response is written, even after the client has
+// stopped sending.
+
+class RootServer {
+  public:
+    RootServer(const std::string& path, int maxDegree, int threads = 0, int maxBatch = 32);
+    ~RootServer(void);
+    void stop(void);
+    int getConnections(void) const;
+    long long getRequests(void) const;
+
+  private:
+    struct Connection {
+      int fd;
+      // Read by the polling thread alone
+      std::vector<char> in;
+      unsigned long long skip{0};
+      bool reading{true};
+      // Whether responses wait, and since when none of them was taken
+      bool waiting{false};
+      std::chrono::steady_clock::time_point taken;
+      // Responses not yet written from sent on, requests in the pool, and whether the
+      // connection is dropped, shared with the workers
+      std::mutex lock;
+      std::vector<char> out;
+      size_t sent{0};
+      int solving{0};
+      bool gone{false};
+      explicit Connection(int fd) : fd(fd) {}
+      ~Connection(void) { close(fd); }
+    };
+
+    std::string path;
+    int maxDegree;
+    int listener{-1};
+    // The polling thread is told to stop on wake, and that responses are queued on ready
+    int wake[2];
+    int ready[2];
+    AsyncRoots pool;
+    std::map<int, std::shared_ptr<Connection> > connections;
+    std::atomic<int> open{0};
+    std::atomic<long long> requests{0};
+    std::thread loop;
+
+    static const size_t MaxPending = 1 << 20;
+    static const int MaxSolving = 256;
+
+    void run(void);
+    bool receive(std::shared_ptr<Connection>& c);
+    bool parse(std::shared_ptr<Connection>& c);
+    bool flush(Connection& c);
+    void respond(Connection& c, std::uint32_t id, const RootResult& r, bool solved);
+};
+
+// Client of RootServer. solve sends one polynomial and waits for its roots; send and
+// receive keep several under way on the connection.
+class RootClient {
+  public:
+    explicit RootClient(const std::string& path);
+    ~RootClient(void);
+    RootResult solve(const std::vector<double>& coeff);
+    void send(std::uint32_t id, const std::vector<double>& coeff);
+    std::uint32_t receive(RootResult& result);
+
+  private:
+    int fd;
+    std::uint32_t next{0};
+
+    void write(const void* data, size_t bytes);
+    void read(void* data, size_t bytes);
+};
+
+inline RootServer::RootServer(const std::string& path, int maxDegree, int threads, int maxBatch)
+  : path(path), maxDegree(maxDegree), pool(maxDegree, threads, maxBatch) {
+  sockaddr_un address;
+  if(path.size() >= sizeof(address.sun_path)) {
+    throw std::invalid_argument( "The socket path is too long." );
+  }
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strcpy(address.sun_path, path.c_str());
+  unlink(path.c_str());
+
+  listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(listener < 0 || bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 128) != 0
+     || pipe(wake) != 0) {
+    if(listener >= 0)   close(listener);
+    throw std::runtime_error( "The socket could not be opened: " + path );
+  }
+  if(pipe(ready) != 0) {
+    close(listener);
+    close(wake[0]);
+    close(wake[1]);
+    throw std::runtime_error( "The socket could not be opened: " + path );
+  }
+  fcntl(listener, F_SETFL, O_NONBLOCK);
+  // A full pipe already wakes the polling thread
+  fcntl(ready[0], F_SETFL, O_NONBLOCK);
+  fcntl(ready[1], F_SETFL, O_NONBLOCK);
+  loop = std::thread(&RootServer::run, this);
+}
+
+inline RootServer::~RootServer(void) {
+  stop();
+  close(wake[0]);
+  close(wake[1]);
+  close(ready[0]);
+  close(ready[1]);
+}
+
+// Stops taking requests; those already taken are answered, however long they take to
+// solve. A client that takes none of its waiting responses for a second loses the rest.
+inline void RootServer::stop(void) {
+  if(!loop.joinable()) return;
+  char byte{0};
+  while(::write(wake[1], &byte, 1) < 0 && errno == EINTR) {}
+  loop.join();
+  close(listener);
+  unlink(path.c_str());
+}
+
+inline int RootServer::getConnections(void) const {
+  return open;
+}
+
+inline long long RootServer::getRequests(void) const {
+  return requests;
+}
+
+// Queues the response to request id, from the polling thread or, for a request solved in
+// the pool, a worker. The polling thread is woken when the queue was empty or the
+// connection has room for requests again, and not at all once the connection is dropped,
+// after which the pipe may be gone.
+inline void RootServer::respond(Connection& c, std::uint32_t id, const RootResult& r, bool solved) {
+  ResponseFrame response{ResponseMagic, id, (std::int32_t)r.status, (std::uint32_t)r.found};
+  std::lock_guard<std::mutex> guard(c.lock);
+  if(solved)   c.solving--;
+  if(c.gone) return;
+  bool wanted = (c.out.size() == c.sent || (solved && c.solving == MaxSolving - 1));
+  const char* frame = (const char*)&response;
+  c.out.insert(c.out.end(), frame, frame + sizeof(response));
+  if(r.found > 0) {
+    c.out.insert(c.out.end(), (const char*)r.zr.data(), (const char*)(r.zr.data() + r.found));
+    c.out.insert(c.out.end(), (const char*)r.zi.data(), (const char*)(r.zi.data() + r.found));
+  }
+  if(wanted) {
+    char byte{0};
+    while(::write(ready[1], &byte, 1) < 0 && errno == EINTR) {}
+  }
+}
+
+// Writes what the client takes of the queued responses; false once it is gone
+inline bool RootServer::flush(Connection& c) {
+  std::lock_guard<std::mutex> guard(c.lock);
+  while(c.sent < c.out.size()) {
+    ssize_t n = ::send(c.fd, &c.out[c.sent], c.out.size() - c.sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if(n < 0 && errno == EINTR) continue;
+    if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    if(n <= 0) return false;
+    c.sent += n;
+    c.taken = std::chrono::steady_clock::now();
+  }
+  if(c.sent == c.out.size()) {
+    c.out.clear();
+    c.sent = 0;
+  }
+  else if(c.sent >= c.out.size()/2) {
+    c.out.erase(c.out.begin(), c.out.begin() + c.sent);
+    c.sent = 0;
+  }
+  return true;
+}
+
+// Reads what there is and submits the complete requests; false once the client has
+// stopped sending or the connection is to be closed
+inline bool RootServer::receive(std::shared_ptr<Connection>& c) {
+  char buffer[65536];
+  bool end{false};
+  for(;;) {
+    ssize_t n = recv(c->fd, buffer, sizeof(buffer), 0);
+    if(n < 0 && errno == EINTR) continue;
+    if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    if(n <= 0) {
+      end = true;
+      break;
+    }
+    c->in.insert(c->in.end(), buffer, buffer + n);
+  }
+  return parse(c) && !end;
+}
+
+// Submits the complete requests read, while the connection has room for their responses;
+// false on a malformed frame
+inline bool RootServer::parse(std::shared_ptr<Connection>& c) {
+  size_t at{0};
+  for(;;) {
+    // The coefficients of a refused request
+    size_t skipped = (size_t)std::min<unsigned long long>(c->skip, c->in.size() - at);
+    at += skipped;
+    c->skip -= skipped;
+    if(c->skip > 0 || c->in.size() - at < sizeof(RequestFrame)) break;
+    {
+      std::lock_guard<std::mutex> guard(c->lock);
+      if(c->out.size() - c->sent > MaxPending || c->solving >= MaxSolving) break;
+    }
+
+    RequestFrame frame;
+    std::memcpy(&frame, &c->in[at], sizeof(frame));
+    if(frame.magic != RequestMagic || frame.degree < 1) return false;
+    if(frame.degree > (std::uint32_t)maxDegree) {
+      at += sizeof(frame);
+      c->skip = (frame.degree + 1ULL)*sizeof(double);
+      requests++;
+      RootResult r;
+      r.status = RootStatus::DegreeTooLarge;
+      r.found = 0;
+      respond(*c, frame.id, r, false);
+      continue;
+    }
+    size_t bytes = sizeof(frame) + (frame.degree + 1)*sizeof(double);
+    if(c->in.size() - at < bytes) break;
+
+    std::vector<double> coeff(frame.degree + 1);
+    std::memcpy(coeff.data(), &c->in[at + sizeof(frame)], coeff.size()*sizeof(double));
+    at += bytes;
+    requests++;
+    {
+      std::lock_guard<std::mutex> guard(c->lock);
+      c->solving++;
+    }
+
+    std::shared_ptr<Connection> to = c;
+    std::uint32_t id = frame.id;
+    pool.submit(coeff, [this, to, id](RootResult& r) { respond(*to, id, r, true); });
+  }
+  c->in.erase(c->in.begin(), c->in.begin() + at);
+  return true;
+}
+
+inline void RootServer::run(void) {
+  typedef std::chrono::steady_clock Clock;
+  std::vector<pollfd> fds;
+  bool stopping{false};
+  for(;;) {
+    // After the stop: until the first client with responses waiting has taken none for a
+    // second, or without limit while there are only solves to wait for
+    Clock::time_point now = Clock::now(), giveUp = Clock::time_point::max();
+    fds.clear();
+    // The stop byte stays in the pipe, so it is only watched for until it comes
+    fds.push_back(pollfd{wake[0], (short)(stopping ? 0 : POLLIN), 0});
+    fds.push_back(pollfd{ready[0], POLLIN, 0});
+    fds.push_back(pollfd{listener, (short)(stopping ? 0 : POLLIN), 0});
+    for(std::map<int, std::shared_ptr<Connection> >::iterator it=connections.begin(); it!=connections.end(); ) {
+      Connection& c = *it->second;
+      // Requests left over once the connection had no room, now that it may have
+      if(c.reading && !stopping && !c.in.empty() && !parse(it->second)) {
+        shutdown(c.fd, SHUT_RD);
+        c.reading = false;
+      }
+      size_t pending;
+      bool room;
+      {
+        std::lock_guard<std::mutex> guard(c.lock);
+        pending = c.out.size() - c.sent;
+        room = (pending <= MaxPending && c.solving < MaxSolving);
+        if(pending > 0 && !c.waiting)   c.taken = now;
+        c.waiting = (pending > 0);
+        bool stalled = (stopping && pending > 0 && now - c.taken >= std::chrono::seconds(1));
+        if(((!c.reading || stopping) && c.solving == 0 && pending == 0) || stalled) {
+          // Every response written, or the rest dropped
+          c.gone = true;
+          it = connections.erase(it);
+          open--;
+          continue;
+        }
+      }
+      if(pending > 0)   giveUp = std::min(giveUp, c.taken + std::chrono::seconds(1));
+      short events = ((c.reading && !stopping && room) ? POLLIN : 0) | ((pending > 0) ? POLLOUT : 0);
+      fds.push_back(pollfd{it->first, events, 0});
+      ++it;
+    }
+    if(stopping && connections.empty()) break;
+
+    int timeout{-1};
+    if(stopping && giveUp != Clock::time_point::max()) {
+      timeout = 1 + std::chrono::duration_cast<std::chrono::milliseconds>(giveUp - now).count();
+    }
+    int n = poll(fds.data(), fds.size(), timeout);
+    if(n < 0) {
+      if(errno == EINTR) continue;
+      break;
+    }
+    if(fds[0].revents != 0)   stopping = true;
+    if(fds[1].revents != 0) {
+      char buffer[256];
+      while(::read(ready[0], buffer, sizeof(buffer)) > 0) {}
+    }
+
+    if(fds[2].revents & POLLIN) {
+      for(int fd=accept(listener, nullptr, nullptr); fd>=0; fd=accept(listener, nullptr, nullptr)) {
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        connections[fd] = std::make_shared<Connection>(fd);
+        open++;
+      }
+    }
+    for(size_t j=3; j<fds.size(); j++) {
+      if(fds[j].revents == 0) continue;
+      std::map<int, std::shared_ptr<Connection> >::iterator it = connections.find(fds[j].fd);
+      Connection& c = *it->second;
+      bool alive = !(fds[j].revents & (POLLERR | POLLHUP | POLLNVAL));
+      if(alive && (fds[j].revents & POLLOUT))   alive = flush(c);
+      if(alive && (fds[j].revents & POLLIN) && !receive(it->second)) {
+        // Closed once the responses still being solved are written
+        shutdown(c.fd, SHUT_RD);
+        c.reading = false;
+      }
+      if(!alive) {
+        {
+          std::lock_guard<std::mutex> guard(c.lock);
+          c.gone = true;
+          c.out.clear();
+          c.sent = 0;
+        }
+        connections.erase(it);
+        open--;
+      }
+    }
+  }
+  // The responses still to come are dropped
+  for(std::map<int, std::shared_ptr<Connection> >::iterator it=connections.begin(); it!=connections.end(); ++it) {
+    std::lock_guard<std::mutex> guard(it->second->lock);
+    it->second->gone = true;
+  }
+  connections.clear();
+  open = 0;
+}
+
+inline RootClient::RootClient(const std::string& path) {
+  sockaddr_un address;
+  if(path.size() >= sizeof(address.sun_path)) {
+    throw std::invalid_argument( "The socket path is too long." );
+  }
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strcpy(address.sun_path, path.c_str());
+  fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(fd < 0 || connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+    if(fd >= 0)   close(fd);
+    throw std::runtime_error( "No server at " + path );
+  }
+}
+
+inline RootClient::~RootClient(void) {
+  close(fd);
+}
+
+inline void RootClient::write(const void* data, size_t bytes) {
+  const char* p = (const char*)data;
+  while(bytes > 0) {
+    ssize_t n = ::send(fd, p, bytes, MSG_NOSIGNAL);
+    if(n < 0 && errno == EINTR) continue;
+    if(n <= 0) {
+      throw std::runtime_error( "The connection to the server is lost." );
+    }
+    p += n;
+    bytes -= n;
+  }
+}
+
+inline void RootClient::read(void* data, size_t bytes) {
+  char* p = (char*)data;
+  while(bytes > 0) {
+    ssize_t n = recv(fd, p, bytes, 0);
+    if(n < 0 && errno == EINTR) continue;
+    if(n <= 0) {
+      throw std::runtime_error( "The connection to the server is lost." );
+    }
+    p += n;
+    bytes -= n;
+  }
+}
+
+inline void RootClient::send(std::uint32_t id, const std::vector<double>& coeff) {
+  if(coeff.size() < 2) {
+    throw std::invalid_argument( "A polynomial needs at least two coefficients." );
+  }
+  RequestFrame frame{RequestMagic, id, (std::uint32_t)coeff.size() - 1, 0};
+  std::vector<char> out(sizeof(frame) + coeff.size()*sizeof(double));
+  std::memcpy(out.data(), &frame, sizeof(frame));
+  std::memcpy(&out[sizeof(frame)], coeff.data(), coeff.size()*sizeof(double));
+  write(out.data(), out.size());
+}
+
+// The id of the request answered
+inline std::uint32_t RootClient::receive(RootResult& result) {
+  ResponseFrame frame;
+  read(&frame, sizeof(frame));
+  if(frame.magic != ResponseMagic) {
+    throw std::runtime_error( "The server sent a malformed response." );
+  }
+  result.status = (RootStatus)frame.status;
+  result.found = frame.found;
+  result.zr.resize(frame.found);
+  result.zi.resize(frame.found);
+  read(result.zr.data(), frame.found*sizeof(double));
+  read(result.zi.data(), frame.found*sizeof(double));
+  return frame.id;
+}
+
+inline RootResult RootClient::solve(const std::vector<double>& coeff) {
+  std::uint32_t id = next++;
+  send(id, coeff);
+  RootResult result;
+  while(receive(result) != id) {}
+  return result;
+}
+
+#endif
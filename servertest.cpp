@@ -0,0 +1,179 @@
+#include "gmock/gmock.h"
+
+#include "server.h"
+#include "akiti.h"
+#include "roots.h"
+
+#include <vector>
+#include <thread>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace testing;
+
+class Server: public Test {
+  public:
+    std::string path = "/tmp/rootstest-" + std::to_string(getpid()) + ".sock";
+
+    // (x - k)(x + 2k)(x - 3k)
+    std::vector<double> cubic(double k) {
+      return {1.0, 0.0, -7.0*k*k, 6.0*k*k*k};
+    }
+};
+
+TEST_F(Server, ClientGetsTheRootsOfRoots) {
+  RootServer server(path, 10, 2);
+  RootClient client(path);
+  // (x - 1)(x - 2)(x - 3)(x^2 + 1)
+  std::vector<double> coeff = {1.0, -6.0, 12.0, -12.0, 11.0, -6.0};
+  RootResult r = client.solve(coeff);
+
+  Akiti akiti(10);
+  Roots rootfinder(&akiti);
+  int degree;
+  std::vector<double> zr, zi;
+  rootfinder.findRoots(coeff);
+  rootfinder.getRoots(degree, zr, zi);
+
+  ASSERT_THAT(r.status, Eq(RootStatus::Success));
+  ASSERT_THAT(r.found, Eq(5));
+  for(int j=0; j<5; j++) {
+    ASSERT_THAT(r.zr[j], Eq(zr[j]));
+    ASSERT_THAT(r.zi[j], Eq(zi[j]));
+  }
+  ASSERT_THAT(client.solve(std::vector<double>(12, 1.0)).status, Eq(RootStatus::DegreeTooLarge));
+  // Coefficients skipped, not kept, and the connection still in step
+  ASSERT_THAT(client.solve(std::vector<double>(300001, 1.0)).status, Eq(RootStatus::DegreeTooLarge));
+  ASSERT_THAT(client.solve(cubic(2.0)).found, Eq(3));
+}
+
+TEST_F(Server, PipelinedRequestsOfManyClientsAreMatchedById) {
+  RootServer server(path, 10, 3, 4);
+  std::vector<std::thread> clients;
+  std::vector<int> wrong(4, 0);
+  for(int c=0; c<4; c++) {
+    clients.push_back(std::thread([&, c]() {
+      RootClient client(path);
+      for(int j=1; j<=50; j++) client.send(j, cubic(c*50 + j));
+      std::vector<bool> seen(51, false);
+      for(int j=1; j<=50; j++) {
+        RootResult r;
+        std::uint32_t id = client.receive(r);
+        double k = c*50 + id, sum{0.0};
+        for(int i=0; i<r.found; i++) sum += std::fabs(r.zr[i]);
+        // |k| + |-2k| + |3k|
+        if(id < 1 || id > 50 || seen[id] || r.found != 3 || std::fabs(sum - 6.0*k) > 1.0e-9*k) wrong[c]++;
+        else seen[id] = true;
+      }
+    }));
+  }
+  for(int c=0; c<4; c++) clients[c].join();
+  ASSERT_THAT(wrong, Each(Eq(0)));
+  ASSERT_THAT(server.getRequests(), Eq(200));
+}
+
+TEST_F(Server, MalformedFrameClosesOnlyItsConnection) {
+  RootServer server(path, 10, 1);
+  RootClient good(path);
+  {
+    RootClient bad(path);
+    ASSERT_THROW(bad.send(1, std::vector<double>(1, 1.0)), std::invalid_argument);
+  }
+  // A raw frame of a wrong magic
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strcpy(address.sun_path, path.c_str());
+  ASSERT_THAT(connect(fd, (sockaddr*)&address, sizeof(address)), Eq(0));
+  RequestFrame frame{0, 1, 3, 0};
+  ASSERT_THAT(write(fd, &frame, sizeof(frame)), Eq((ssize_t)sizeof(frame)));
+  char byte;
+  ASSERT_THAT(read(fd, &byte, 1), Eq(0));
+  close(fd);
+
+  ASSERT_THAT(good.solve(cubic(2.0)).found, Eq(3));
+}
+
+TEST_F(Server, ClientThatNeverReadsHoldsUpNoOther) {
+  RootServer server(path, 100, 2, 32);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strcpy(address.sun_path, path.c_str());
+  ASSERT_THAT(connect(fd, (sockaddr*)&address, sizeof(address)), Eq(0));
+
+  // 3000 requests of degree 100 pipelined, and not one response read
+  std::atomic<int> sent{0};
+  std::thread flood([&]() {
+    RequestFrame frame{RequestMagic, 0, 100, 0};
+    std::vector<char> out(sizeof(frame) + 101*sizeof(double));
+    std::vector<double> coeff(101, 1.0);
+    std::memcpy(&out[sizeof(frame)], coeff.data(), coeff.size()*sizeof(double));
+    for(int j=0; j<3000; j++) {
+      frame.id = j;
+      std::memcpy(out.data(), &frame, sizeof(frame));
+      for(size_t at=0; at<out.size(); ) {
+        ssize_t n = send(fd, &out[at], out.size() - at, MSG_NOSIGNAL);
+        if(n <= 0) return;
+        at += n;
+      }
+      sent++;
+    }
+  });
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while(server.getRequests() < 300 && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+  if(server.getRequests() < 300) {
+    shutdown(fd, SHUT_RDWR);
+    flood.join();
+    close(fd);
+    FAIL() << "The server took " << server.getRequests() << " of the requests in 10 s";
+  }
+
+  RootClient other(path);
+  ASSERT_THAT(other.solve(cubic(2.0)).found, Eq(3));
+  // Stopped reading the first long before its last request
+  ASSERT_THAT(sent, Lt(3000));
+  ASSERT_THAT(server.getRequests(), Lt(3000));
+
+  shutdown(fd, SHUT_RDWR);
+  flood.join();
+  close(fd);
+}
+
+TEST_F(Server, StopAnswersRequestsStillBeingSolved) {
+  // Akiti gives up on this one after a few seconds of shifts
+  int N = 8000;
+  RootServer server(path, N, 1);
+  RootClient client(path);
+  std::vector<double> coeff(N + 1);
+  for(int j=0; j<=N; j++) coeff[j] = 1.0/(1.0 + j);
+  client.send(7, coeff);
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while(server.getRequests() < 1 && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+  ASSERT_THAT(server.getRequests(), Eq(1));
+
+  // The solve goes on for more than a second after the stop, with nothing to send
+  std::thread stopper([&]() { server.stop(); });
+  RootResult r;
+  std::uint32_t id{0};
+  try {
+    id = client.receive(r);
+  }
+  catch (const std::runtime_error&) {
+  }
+  stopper.join();
+  ASSERT_THAT(id, Eq(7u));
+  EXPECT_THAT(r.status, Eq(RootStatus::NoConvergence));
+  EXPECT_THAT(r.found, Lt(N));
+}
+
+TEST_F(Server, NoServerThrows) {
+  ASSERT_THROW(RootClient client(path), std::runtime_error);
+}
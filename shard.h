@@ -0,0 +1,344 @@
+#include "akiti.h"
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+
+#ifndef ShardRunner_h
+#define ShardRunner_h
+
+// Results of a sharded run, in memory shared between processes: anonymous, or mapped from
+// a file that survives the run.
+//
+// The file holds a header of the count and the degree, then the status and the number of
+// roots found of every row, then the real and the imaginary parts of the N roots of every
+// row, each at an offset known from the row alone, so that any process writes its rows in
+// place. A row is Pending until its roots are all written, and its status is written last,
+// so a process that dies halfway leaves its row Pending. Opening an existing file of the
+// same count and degree keeps what is in it, and a run then solves the rows still Pending.
+
+class ShardResults {
+  public:
+    static const int Pending = -1;
+    static const int Crashed = -2;
+
+    ShardResults(int count, int N);
+    ShardResults(const std::string& path, int count, int N);
+    ~ShardResults(void);
+    ShardResults(const ShardResults&) = delete;
+    ShardResults& operator=(const ShardResults&) = delete;
+
+    int getCount(void) const;
+    int getDegree(void) const;
+    double* zr(int b);
+    double* zi(int b);
+    int found(int b) const;
+    // A RootStatus, Pending or Crashed
+    int status(int b) const;
+    void store(int b, int found, int status);
+
+  private:
+    struct Header {
+      char magic[8];
+      std::int64_t count;
+      std::int64_t N;
+      char padding[40];
+    };
+
+    int count;
+    int N;
+    size_t bytes;
+    char* base{nullptr};
+    std::int32_t* status_{nullptr};
+    std::int32_t* found_{nullptr};
+    double* zr_{nullptr};
+    double* zi_{nullptr};
+
+    size_t layout(void);
+    void map(bool fresh);
+};
+
+// Solves count polynomials of degree N in shards of shardSize rows, each in a child
+// process of its own, with up to processes of them at a time; the children write the roots
+// straight into ShardResults.
+//
+// A child that dies, by a signal, an exit status other than zero, or after timeout seconds
+// without finishing its shard, loses only the rows it had not stored. Its shard goes back
+// into the queue, up to maxRetries times, and then in halves, each with the retries again,
+// down to the row that kills the child, which is marked Crashed. A crash in one bad input
+// thus costs a few processes and that row, and neither the run nor the other rows.
+//
+// The coefficients of row b are at c + b*(N+1); the children read them from the memory of
+// the parent, which fork shares, and a coefficient file is mapped rather than read. The
+// range [begin, end) of the rows lets several hosts split one file, each with its own
+// result file. hook, if set, is called in the child before each row.
+
+class ShardRunner {
+  public:
+    ShardRunner(int processes, int shardSize = 1024, int maxRetries = 2, int timeout = 0);
+    int run(const double* c, ShardResults& results, int begin = 0, int end = -1);
+    int run(const std::string& input, ShardResults& results, int begin = 0, int end = -1);
+    void setHook(std::function<void(int)> hook);
+    int getCrashes(void) const;
+
+  private:
+    struct Shard {
+      int first;
+      int count;
+      int attempt;
+    };
+
+    int processes;
+    int shardSize;
+    int maxRetries;
+    int timeout;
+    int crashes{0};
+    std::function<void(int)> hook;
+
+    void child(const double* c, ShardResults& results, const Shard& shard);
+};
+
+inline ShardResults::ShardResults(int count, int N) : count(count), N(N) {
+  bytes = layout();
+  void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if(p == MAP_FAILED) {
+    throw std::runtime_error( "The shared memory for the results could not be mapped." );
+  }
+  base = (char*)p;
+  map(true);
+}
+
+inline ShardResults::ShardResults(const std::string& path, int count, int N) : count(count), N(N) {
+  bytes = layout();
+  int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if(fd < 0) {
+    throw std::runtime_error( "The result file could not be opened: " + path );
+  }
+  struct stat st;
+  bool fresh = (fstat(fd, &st) != 0 || (size_t)st.st_size != bytes);
+  if(fresh && ftruncate(fd, bytes) != 0) {
+    close(fd);
+    throw std::runtime_error( "The result file could not be sized: " + path );
+  }
+  void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if(p == MAP_FAILED) {
+    throw std::runtime_error( "The result file could not be mapped: " + path );
+  }
+  base = (char*)p;
+  map(fresh);
+}
+
+inline ShardResults::~ShardResults(void) {
+  if(base != nullptr)   munmap(base, bytes);
+}
+
+// Offsets of the parts; returns the size of the whole
+inline size_t ShardResults::layout(void) {
+  if(count < 0 || N < 1) {
+    throw std::invalid_argument( "Results need a count of rows and a degree of at least one." );
+  }
+  size_t ints = ((2*(size_t)count*sizeof(std::int32_t) + 7)/8)*8;
+  return sizeof(Header) + ints + 2*(size_t)count*N*sizeof(double);
+}
+
+inline void ShardResults::map(bool fresh) {
+  Header* header = (Header*)base;
+  status_ = (std::int32_t*)(base + sizeof(Header));
+  found_ = status_ + count;
+  size_t ints = ((2*(size_t)count*sizeof(std::int32_t) + 7)/8)*8;
+  zr_ = (double*)(base + sizeof(Header) + ints);
+  zi_ = zr_ + (size_t)count*N;
+
+  if(!fresh && std::memcmp(header->magic, "ROOTSRES", 8) == 0 && header->count == count && header->N == N) return;
+  std::memcpy(header->magic, "ROOTSRES", 8);
+  header->count = count;
+  header->N = N;
+  for(int b=0; b<count; b++) {
+    status_[b] = Pending;
+    found_[b] = 0;
+  }
+}
+
+inline int ShardResults::getCount(void) const {
+  return count;
+}
+
+inline int ShardResults::getDegree(void) const {
+  return N;
+}
+
+inline double* ShardResults::zr(int b) {
+  return zr_ + (size_t)b*N;
+}
+
+inline double* ShardResults::zi(int b) {
+  return zi_ + (size_t)b*N;
+}
+
+inline int ShardResults::found(int b) const {
+  return found_[b];
+}
+
+inline int ShardResults::status(int b) const {
+  return __atomic_load_n(&status_[b], __ATOMIC_ACQUIRE);
+}
+
+inline void ShardResults::store(int b, int found, int status) {
+  found_[b] = found;
+  __atomic_store_n(&status_[b], status, __ATOMIC_RELEASE);
+}
+
+inline ShardRunner::ShardRunner(int processes, int shardSize, int maxRetries, int timeout)
+  : processes(processes), shardSize(shardSize), maxRetries(maxRetries), timeout(timeout) {
+  if(this->processes < 1)   this->processes = 1;
+  if(this->shardSize < 1)   this->shardSize = 1;
+}
+
+inline void ShardRunner::setHook(std::function<void(int)> hook) {
+  this->hook = hook;
+}
+
+// Children that died in the last run
+inline int ShardRunner::getCrashes(void) const {
+  return crashes;
+}
+
+inline void ShardRunner::child(const double* c, ShardResults& results, const Shard& shard) {
+  if(timeout > 0)   alarm(timeout);
+  int N = results.getDegree();
+  Akiti akiti(N);
+  std::vector<double> op(N + 1);
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  for(int b=shard.first; b<shard.first+shard.count; b++) {
+    if(results.status(b) != ShardResults::Pending) continue;
+    if(hook)   hook(b);
+    std::memcpy(op.data(), c + (size_t)b*(N + 1), (N + 1)*sizeof(double));
+    int n{0};
+    RootStatus status = akiti.solve(op.data(), N, results.zr(b), results.zi(b), &n);
+    for(int j=n; j<N; j++) results.zr(b)[j] = results.zi(b)[j] = nan;
+    results.store(b, n, (int)status);
+  }
+}
+
+// Returns the number of rows in [begin, end) not solved completely, Crashed included
+inline int ShardRunner::run(const double* c, ShardResults& results, int begin, int end) {
+  if(end < 0 || end > results.getCount())   end = results.getCount();
+  crashes = 0;
+
+  std::deque<Shard> queue;
+  for(int first=begin; first<end; first+=shardSize) {
+    Shard shard{first, std::min(shardSize, end - first), 0};
+    bool pending = false;
+    for(int b=shard.first; b<shard.first+shard.count && !pending; b++) {
+      pending = (results.status(b) == ShardResults::Pending);
+    }
+    if(pending)   queue.push_back(shard);
+  }
+
+  std::map<pid_t, Shard> running;
+  while(!queue.empty() || !running.empty()) {
+    while((int)running.size() < processes && !queue.empty()) {
+      pid_t pid = fork();
+      if(pid == 0) {
+        int code{0};
+        try {
+          child(c, results, queue.front());
+        }
+        catch (...) {
+          code = 1;
+        }
+        _exit(code);
+      }
+      if(pid < 0) {
+        if(running.empty()) {
+          throw std::runtime_error( "No worker process could be started." );
+        }
+        break;
+      }
+      running[pid] = queue.front();
+      queue.pop_front();
+    }
+
+    // Only the children of this run are waited for
+    int st;
+    pid_t pid{0};
+    std::map<pid_t, Shard>::iterator it;
+    for(;;) {
+      for(it=running.begin(); it!=running.end(); ++it) {
+        pid = waitpid(it->first, &st, WNOHANG);
+        if(pid != 0) break;
+      }
+      if(it != running.end()) break;
+      usleep(1000);
+    }
+    Shard shard = it->second;
+    running.erase(it);
+    if(pid > 0 && WIFEXITED(st) && WEXITSTATUS(st) == 0) continue;
+
+    crashes++;
+    if(shard.attempt < maxRetries) {
+      shard.attempt++;
+      queue.push_back(shard);
+    }
+    else if(shard.count > 1) {
+      int half = shard.count/2;
+      queue.push_back(Shard{shard.first, half, 0});
+      queue.push_back(Shard{shard.first + half, shard.count - half, 0});
+    }
+    else if(results.status(shard.first) == ShardResults::Pending) {
+      results.store(shard.first, 0, ShardResults::Crashed);
+    }
+  }
+
+  int failed{0};
+  for(int b=begin; b<end; b++) {
+    if(results.status(b) != (int)RootStatus::Success)   failed++;
+  }
+  return failed;
+}
+
+// The coefficients from a file of count*(N+1) doubles in the byte order of the machine
+inline int ShardRunner::run(const std::string& input, ShardResults& results, int begin, int end) {
+  int fd = open(input.c_str(), O_RDONLY);
+  if(fd < 0) {
+    throw std::runtime_error( "The coefficient file could not be opened: " + input );
+  }
+  struct stat st;
+  size_t bytes = (size_t)results.getCount()*(results.getDegree() + 1)*sizeof(double);
+  if(fstat(fd, &st) != 0 || (size_t)st.st_size < bytes) {
+    close(fd);
+    throw std::invalid_argument( "The coefficient file is shorter than the rows of the results." );
+  }
+  void* p = mmap(nullptr, std::max<size_t>(bytes, 1), PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(p == MAP_FAILED) {
+    throw std::runtime_error( "The coefficient file could not be mapped: " + input );
+  }
+  int failed;
+  try {
+    failed = run((const double*)p, results, begin, end);
+  }
+  catch (...) {
+    munmap(p, std::max<size_t>(bytes, 1));
+    throw;
+  }
+  munmap(p, std::max<size_t>(bytes, 1));
+  return failed;
+}
+
+#endif
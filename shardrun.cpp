@@ -0,0 +1,44 @@
+#include "shard.h"
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <stdexcept>
+
+// Driver of ShardRunner:
+//
+//   shardrun N input output [processes] [shardSize] [begin end]
+//
+// Solves the rows of the coefficient file input, each N+1 doubles in the byte order of
+// the machine, leading coefficient first, into the result file output, which a second run
+// resumes. begin and end restrict the run to those rows, for one host of several.
+
+int main(int argc, char** argv) {
+  if(argc < 4) {
+    std::cerr << "usage: " << argv[0] << " N input output [processes] [shardSize] [begin end]" << std::endl;
+    return 2;
+  }
+  int N = std::atoi(argv[1]);
+  std::string input = argv[2], output = argv[3];
+  int processes = ((argc > 4) ? std::atoi(argv[4]) : 1);
+  int shardSize = ((argc > 5) ? std::atoi(argv[5]) : 1024);
+  int begin = ((argc > 7) ? std::atoi(argv[6]) : 0);
+  int end = ((argc > 7) ? std::atoi(argv[7]) : -1);
+
+  try {
+    struct stat st;
+    if(N < 1 || stat(input.c_str(), &st) != 0) {
+      throw std::invalid_argument( "A degree of at least one and a coefficient file are needed." );
+    }
+    int count = st.st_size/((N + 1)*sizeof(double));
+    ShardResults results(output, count, N);
+    ShardRunner runner(processes, shardSize);
+    int failed = runner.run(input, results, begin, end);
+    std::cout << count << " rows, " << failed << " not solved, " << runner.getCrashes() << " worker crashes" << std::endl;
+    return ((failed > 0) ? 1 : 0);
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 2;
+  }
+}
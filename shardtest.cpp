@@ -0,0 +1,91 @@
+#include "gmock/gmock.h"
+
+#include "shard.h"
+#include "batch.h"
+
+#include <vector>
+#include <random>
+#include <cstdio>
+#include <csignal>
+#include <unistd.h>
+
+using namespace testing;
+
+class Sharded: public Test {
+  public:
+    int count{300};
+    int N{8};
+    std::vector<double> c;
+    std::vector<double> zr, zi;
+
+    void SetUp() override {
+      std::mt19937 rng(9);
+      std::uniform_real_distribution<double> u(-1.0, 1.0);
+      c.resize(count*(N + 1));
+      for(size_t j=0; j<c.size(); j++) c[j] = u(rng);
+      zr.resize(count*N);
+      zi.resize(count*N);
+      BatchSolver batch(N, 1);
+      batch.solve(count, N, c.data(), N + 1, zr.data(), zi.data(), N, nullptr);
+    }
+
+    bool same(ShardResults& results, int b) {
+      for(int j=0; j<N; j++) {
+        if(results.zr(b)[j] != zr[b*N + j] || results.zi(b)[j] != zi[b*N + j]) return false;
+      }
+      return true;
+    }
+};
+
+TEST_F(Sharded, ProcessesWriteTheRootsInPlace) {
+  ShardResults results(count, N);
+  ShardRunner runner(3, 32);
+  ASSERT_THAT(runner.run(c.data(), results), Eq(0));
+  ASSERT_THAT(runner.getCrashes(), Eq(0));
+  for(int b=0; b<count; b++) {
+    ASSERT_THAT(results.status(b), Eq((int)RootStatus::Success));
+    ASSERT_THAT(results.found(b), Eq(N));
+    ASSERT_TRUE(same(results, b));
+  }
+}
+
+TEST_F(Sharded, CrashingRowIsIsolatedAndTheRestSolved) {
+  ShardResults results(count, N);
+  ShardRunner runner(2, 64, 1);
+  runner.setHook([](int b) { if(b == 137) raise(SIGKILL); });
+  ASSERT_THAT(runner.run(c.data(), results), Eq(1));
+  ASSERT_THAT(runner.getCrashes(), Gt(0));
+  for(int b=0; b<count; b++) {
+    if(b == 137) {
+      ASSERT_THAT(results.status(b), Eq(ShardResults::Crashed));
+      continue;
+    }
+    ASSERT_THAT(results.status(b), Eq((int)RootStatus::Success));
+    ASSERT_TRUE(same(results, b));
+  }
+}
+
+TEST_F(Sharded, ResultFileResumesWhereTheRunStopped) {
+  char input[] = "/tmp/shardinXXXXXX";
+  int fd = mkstemp(input);
+  ASSERT_THAT(write(fd, c.data(), c.size()*sizeof(double)), Eq((ssize_t)(c.size()*sizeof(double))));
+  close(fd);
+  std::string output = std::string(input) + ".out";
+
+  {
+    // The first half of the rows, as one host of two would
+    ShardResults results(output, count, N);
+    ShardRunner runner(2, 50);
+    ASSERT_THAT(runner.run(input, results, 0, 150), Eq(0));
+    ASSERT_THAT(results.status(150), Eq(ShardResults::Pending));
+  }
+  {
+    ShardResults results(output, count, N);
+    ShardRunner runner(2, 50);
+    ASSERT_THAT(results.status(149), Eq((int)RootStatus::Success));
+    ASSERT_THAT(runner.run(input, results), Eq(0));
+    for(int b=0; b<count; b++) ASSERT_TRUE(same(results, b));
+  }
+  remove(input);
+  remove(output.c_str());
+}
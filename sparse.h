@@ -0,0 +1,136 @@
+#include <vector>
+#include <complex>
+#include <cmath>
+
+#ifndef SparsePoly_h
+#define SparsePoly_h
+
+// Polynomial given by its nonzero terms, like x^1000 - 3x^17 + 1. The terms are kept in
+// order of decreasing exponent and evaluated by a sparse Horner scheme: the gap between
+// consecutive exponents is bridged by exponentiation by squaring, so the cost grows with
+// the number of terms and the logarithm of the degree instead of the degree.
+
+class SparsePoly {
+  public:
+    SparsePoly(void);
+    ~SparsePoly(void);
+    void addTerm(int exponent, double coefficient);
+    int degree(void) const;
+    int terms(void) const;
+    int valuation(void) const;
+    int exponent(int j) const;
+    double coefficient(int j) const;
+    void densify(double* op) const;
+    void shift(int m, SparsePoly& q) const;
+    double evaluate(double x) const;
+    void evaluate(std::complex<double> z, std::complex<double>& pz, std::complex<double>& dpz) const;
+    double bound(double r) const;
+
+  private:
+    std::vector<int> e;
+    std::vector<double> c;
+
+    template<class T> T power(T x, int n) const;
+};
+
+inline SparsePoly::SparsePoly(void) {}
+
+inline SparsePoly::~SparsePoly(void) {}
+
+// Terms with equal exponents are merged; terms that cancel are dropped
+inline void SparsePoly::addTerm(int exponent, double coefficient) {
+  size_t j{0};
+  while(j < e.size() && e[j] > exponent) j++;
+  if(j < e.size() && e[j] == exponent) {
+    c[j] += coefficient;
+    if(c[j] == 0.0) {
+      e.erase(e.begin() + j);
+      c.erase(c.begin() + j);
+    }
+    return;
+  }
+  if(coefficient == 0.0) return;
+  e.insert(e.begin() + j, exponent);
+  c.insert(c.begin() + j, coefficient);
+}
+
+inline int SparsePoly::degree(void) const {
+  return (e.empty() ? 0 : e[0]);
+}
+
+inline int SparsePoly::terms(void) const {
+  return e.size();
+}
+
+// Multiplicity of the zero at the origin, the lowest exponent
+inline int SparsePoly::valuation(void) const {
+  return (e.empty() ? 0 : e.back());
+}
+
+inline int SparsePoly::exponent(int j) const {
+  return e[j];
+}
+
+// Coefficient of the j-th term in order of decreasing exponent. The leading coefficient
+// of the zero polynomial is zero.
+inline double SparsePoly::coefficient(int j) const {
+  return (e.empty() ? 0.0 : c[j]);
+}
+
+// Dense coefficients C(0)*X^N + ... + C(N), leading coefficient first
+inline void SparsePoly::densify(double* op) const {
+  int N = degree();
+  for(int j=0; j<=N; j++) op[j] = 0.0;
+  for(size_t j=0; j<e.size(); j++) op[N - e[j]] = c[j];
+}
+
+// q(x) = p(x)/x^m for m not greater than the valuation
+inline void SparsePoly::shift(int m, SparsePoly& q) const {
+  q.e.resize(e.size());
+  q.c = c;
+  for(size_t j=0; j<e.size(); j++) q.e[j] = e[j] - m;
+}
+
+template<class T> T SparsePoly::power(T x, int n) const {
+  T y(1.0);
+  while(n > 0) {
+    if(n & 1) y *= x;
+    x *= x;
+    n >>= 1;
+  }
+  return y;
+}
+
+inline double SparsePoly::evaluate(double x) const {
+  if(e.empty()) return 0.0;
+  double px = c[0];
+  for(size_t j=1; j<e.size(); j++) px = px*power(x, e[j - 1] - e[j]) + c[j];
+  return px*power(x, e.back());
+}
+
+// p and p' at z by the sparse Horner scheme. Across a gap g the pair is updated as
+// p <- p z^g + c and p' <- p' z^g + g p z^(g-1).
+inline void SparsePoly::evaluate(std::complex<double> z, std::complex<double>& pz, std::complex<double>& dpz) const {
+  pz = dpz = 0.0;
+  if(e.empty()) return;
+
+  pz = c[0];
+  for(size_t j=1; j<=e.size(); j++) {
+    int g = ((j < e.size()) ? e[j - 1] - e[j] : e.back());
+    if(g == 0) break;
+    std::complex<double> zg1 = power(z, g - 1);
+    std::complex<double> zg  = zg1*z;
+    dpz = dpz*zg + (double)g*pz*zg1;
+    pz  = pz*zg + ((j < e.size()) ? c[j] : 0.0);
+  }
+}
+
+// Sum of |c| r^e, the scale of the rounding error in evaluating p at |z| = r
+inline double SparsePoly::bound(double r) const {
+  if(e.empty()) return 0.0;
+  double b = std::fabs(c[0]);
+  for(size_t j=1; j<e.size(); j++) b = b*power(r, e[j - 1] - e[j]) + std::fabs(c[j]);
+  return b*power(r, e.back());
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include "polyarith.h"
+
+#include <vector>
+
+#ifndef SquareFree_h
+#define SquareFree_h
+
+// Square-free factorization p = a_1 * a_2^2 * ... * a_m^m by Yun's algorithm on an
+// approximate GCD with the derivative. Each a_i has simple roots, so a root finder
+// converges quadratically on every factor instead of linearly near multiple roots.
+
+class SquareFree {
+  public:
+    SquareFree(double tol = 1.0e-10);
+    bool factor(const std::vector<double>& p, std::vector<std::vector<double> >& factors,
+                std::vector<int>& multiplicity) const;
+
+  private:
+    PolyArith arith;
+    double tol;
+
+    void exactQuotient(const std::vector<double>& n, const std::vector<double>& d, std::vector<double>& q) const;
+};
+
+inline SquareFree::SquareFree(double tol) : tol(tol) {}
+
+inline void SquareFree::exactQuotient(const std::vector<double>& n, const std::vector<double>& d,
+                               std::vector<double>& q) const {
+  std::vector<double> r;
+  arith.divide(n, d, q, r);
+}
+
+// Returns false if p is square-free or the factorization is not consistent with the
+// degree of p; factors and multiplicity are then left empty.
+inline bool SquareFree::factor(const std::vector<double>& p, std::vector<std::vector<double> >& factors,
+                        std::vector<int>& multiplicity) const {
+  factors.clear();
+  multiplicity.clear();
+
+  int N = p.size() - 1;
+  if(N < 2 || p[0] == 0.0) return false;
+
+  std::vector<double> f(p), df, g;
+  arith.monic(f);
+  arith.derivative(f, df);
+  arith.gcd(f, df, g, tol);
+  if(g.size() == 1) return false;
+
+  std::vector<double> b, c, d, db, a;
+  exactQuotient(f, g, b);
+  exactQuotient(df, g, c);
+  arith.derivative(b, db);
+  arith.subtract(c, db, d);
+  arith.trim(d, tol);
+
+  int total{0};
+  for(int i=1; b.size() > 1 && i <= N; i++) {
+    if(arith.norm(d) <= tol*arith.norm(c)) d.assign(1, 0.0);
+    arith.gcd(b, d, a, tol);
+    if(a.size() > 1) {
+      factors.push_back(a);
+      multiplicity.push_back(i);
+      total += i*(a.size() - 1);
+    }
+    exactQuotient(b, a, g);
+    b.swap(g);
+    exactQuotient(d, a, c);
+    arith.derivative(b, db);
+    arith.subtract(c, db, d);
+    arith.trim(d, tol);
+  }
+
+  if(total != N || b.size() != 1) {
+    factors.clear();
+    multiplicity.clear();
+    return false;
+  }
+  return true;
+}
+
+#endif
@@ -0,0 +1,162 @@
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+
+#ifndef Stability_h
+#define Stability_h
+
+// Stability of C(0)*X^N + ... + C(N) without computing its roots, in O(N^2) operations.
+//
+// hurwitz tells whether all roots lie in the open left half-plane (continuous time), by
+// the Routh array: its rows start with C(0), C(2), ... and C(1), C(3), ..., each further row
+// eliminates the first element of the row two above it, and the polynomial is Hurwitz
+// stable if and only if the N+1 rows all start with the sign of C(0).
+//
+// schur tells whether all roots lie in the open unit disk (discrete time), by the
+// Schur-Cohn recursion, the Jury test in another arrangement: with p monic of degree k and
+// gamma = p(0), p is Schur stable if and only if |gamma| < 1 and the polynomial
+// (p(z) - gamma z^k p(1/z))/z of degree k-1 is Schur stable.
+//
+// The singular cases are those where a recursion breaks down: a Routh row starting with
+// zero, as when the row vanishes for roots symmetric about the origin, or |gamma| = 1, as
+// for a root on the unit circle or a pair z, 1/z. In each of them some root lies on the
+// boundary or beyond, so the polynomial is not stable; both tests answer false there
+// instead of perturbing the zero. A NaN coefficient also gives false.
+//
+// The batch versions test count polynomials of one degree N at once. The coefficients are
+// stored by coefficient, c[j*count + b] being C(j) of polynomial b. The recursions run on
+// Lanes polynomials side by side as SIMD vectors, with selects instead of branches. A
+// polynomial of the batch with leading coefficient zero is reported as not stable.
+
+class Stability {
+  public:
+    bool hurwitz(const std::vector<double>& c) const;
+    bool schur(const std::vector<double>& c) const;
+    void hurwitz(int count, int N, const double* c, bool* stable) const;
+    void schur(int count, int N, const double* c, bool* stable) const;
+
+  private:
+    // Polynomials of a batch processed side by side in one SSE2 register, as a vector of
+    // the GCC vector extensions. Its natural alignment is that of std::vector's storage.
+    static const int Lanes = 2;
+    typedef double Lane __attribute__((vector_size(Lanes*sizeof(double))));
+    typedef long long Mask __attribute__((vector_size(Lanes*sizeof(long long))));
+
+    void check(const std::vector<double>& c) const;
+    static bool none(Mask ok);
+};
+
+inline void Stability::check(const std::vector<double>& c) const {
+  if(c.empty() || c[0] == 0.0) {
+    throw std::invalid_argument( "The leading coefficient is zero." );
+  }
+}
+
+// True if no lane is left stable, so the rest of the recursion can be skipped
+inline bool Stability::none(Mask ok) {
+  for(int s=0; s<Lanes; s++) {
+    if(ok[s] != 0) return false;
+  }
+  return true;
+}
+
+inline bool Stability::hurwitz(const std::vector<double>& c) const {
+  check(c);
+  int N = c.size() - 1;
+  int L = N/2 + 2;
+  double sign = ((c[0] > 0.0) ? 1.0 : -1.0);
+
+  // The two latest rows of the Routh array, padded with zeros
+  std::vector<double> a(L, 0.0), b(L, 0.0);
+  for(int j=0; 2*j<=N; j++) a[j] = c[2*j];
+  for(int j=0; 2*j+1<=N; j++) b[j] = c[2*j + 1];
+
+  for(int k=1; k<=N; k++) {
+    if(!(sign*b[0] > 0.0)) return false;
+    double q = a[0]/b[0];
+    for(int j=0; j<L-1; j++) a[j] = a[j + 1] - q*b[j + 1];
+    a[L - 1] = 0.0;
+    a.swap(b);
+  }
+  return true;
+}
+
+inline bool Stability::schur(const std::vector<double>& c) const {
+  check(c);
+  int N = c.size() - 1;
+
+  // Monic, in order of increasing power
+  std::vector<double> a(N + 1), t(N + 1);
+  for(int i=0; i<=N; i++) a[i] = c[N - i]/c[0];
+
+  for(int k=N; k>=1; k--) {
+    double gamma = a[0];
+    if(!(fabs(gamma) < 1.0)) return false;
+    double d = 1.0/(1.0 - gamma*gamma);
+    for(int i=0; i<k; i++) t[i] = (a[i + 1] - gamma*a[k - 1 - i])*d;
+    a.swap(t);
+  }
+  return true;
+}
+
+inline void Stability::hurwitz(int count, int N, const double* c, bool* stable) const {
+  int L = N/2 + 2;
+  std::vector<Lane> a(L), b(L);
+  const Lane zero = {0.0, 0.0}, one = zero + 1.0;
+
+  for(int first=0; first<count; first+=Lanes) {
+    // The rows of Lanes polynomials side by side; lanes past the end repeat the last one
+    for(int j=0; j<L; j++) {
+      for(int s=0; s<Lanes; s++) {
+        int m = std::min(first + s, count - 1);
+        a[j][s] = ((2*j <= N) ? c[2*j*count + m] : 0.0);
+        b[j][s] = ((2*j + 1 <= N) ? c[(2*j + 1)*count + m] : 0.0);
+      }
+    }
+    Mask ok = (a[0] != zero);
+    Lane sign = ((a[0] > zero) ? one : -one);
+
+    for(int k=1; k<=N; k++) {
+      Mask good = (sign*b[0] > zero);
+      ok &= good;
+      if(none(ok)) break;
+      // A broken row divides by one instead, its result no longer matters
+      Lane q = a[0]/(good ? b[0] : one);
+      for(int j=0; j<L-1; j++) a[j] = a[j + 1] - q*b[j + 1];
+      a[L - 1] = zero;
+      a.swap(b);
+    }
+
+    for(int s=0; s<Lanes && first + s<count; s++) stable[first + s] = (ok[s] != 0);
+  }
+}
+
+inline void Stability::schur(int count, int N, const double* c, bool* stable) const {
+  std::vector<Lane> a(N + 1), t(N + 1);
+  const Lane zero = {0.0, 0.0}, one = zero + 1.0;
+
+  for(int first=0; first<count; first+=Lanes) {
+    // In order of increasing power; lanes past the end repeat the last polynomial
+    for(int i=0; i<=N; i++) {
+      for(int s=0; s<Lanes; s++) a[i][s] = c[(N - i)*count + std::min(first + s, count - 1)];
+    }
+    Mask ok = (a[N] != zero);
+    Lane d = one/(ok ? a[N] : one);
+    for(int i=0; i<=N; i++) a[i] *= d;
+
+    for(int k=N; k>=1; k--) {
+      Lane gamma = a[0];
+      Mask good = (gamma*gamma < one);
+      ok &= good;
+      if(none(ok)) break;
+      d = one/(good ? one - gamma*gamma : one);
+      for(int i=0; i<k; i++) t[i] = (a[i + 1] - gamma*a[k - 1 - i])*d;
+      a.swap(t);
+    }
+
+    for(int s=0; s<Lanes && first + s<count; s++) stable[first + s] = (ok[s] != 0);
+  }
+}
+
+#endif
@@ -0,0 +1,190 @@
+#include <vector>
+#include <cmath>
+#include <complex>
+
+#ifndef Structure_h
+#define Structure_h
+
+// Structural reductions that shrink the degree handed to rpoly.
+//
+// A polynomial that uses only every k-th power, p(x) = x^m q(x^k), is solved as q(y) of
+// degree (N-m)/k followed by the k-th roots of each y.
+//
+// A palindromic polynomial, C(j) = C(N-j), of even degree N = 2m satisfies
+// p(x)/x^m = q(x + 1/x) with q of degree m; the roots follow from x^2 - w x + 1 = 0 for
+// every root w of q. Odd degree palindromic polynomials carry the factor x+1 and
+// anti-palindromic ones, C(j) = -C(N-j), the factor x-1; dividing them out leaves an even
+// degree palindromic polynomial.
+
+class Structure {
+  public:
+    int lacunarity(const std::vector<double>& c, int& zeros) const;
+    void substitute(const std::vector<double>& c, int k, int zeros, std::vector<double>& q) const;
+    void expandPowers(int n, const double* yr, const double* yi, int k, double* zr, double* zi) const;
+
+    int reciprocal(const std::vector<double>& c) const;
+    int splitReciprocal(const std::vector<double>& c, int sign, std::vector<double>& q, double* zr, double* zi) const;
+    void fold(const std::vector<double>& q, std::vector<double>& w) const;
+    void unfold(int m, const double* wr, const double* wi, double* zr, double* zi) const;
+};
+
+// Largest k with p(x) = x^zeros q(x^k); 1 if there is no such structure
+inline int Structure::lacunarity(const std::vector<double>& c, int& zeros) const {
+  int N = c.size()-1;
+  zeros = 0;
+  while(zeros < N && c[N - zeros] == 0.0) zeros++;
+
+  // gcd of the exponents N-zeros-j of the leading and every nonzero lower term
+  int k = N - zeros;
+  for(int j=1; j<N-zeros && k != 1; j++) {
+    if(c[j] == 0.0) continue;
+    int a = N - zeros - j, b = k;
+    while(b != 0) {
+      int t = a % b;
+      a = b;
+      b = t;
+    }
+    k = a;
+  }
+  return ((k == 0) ? 1 : k);
+}
+
+// Coefficients of q(y) with p(x) = x^zeros q(x^k)
+inline void Structure::substitute(const std::vector<double>& c, int k, int zeros, std::vector<double>& q) const {
+  int n = (c.size() - 1 - zeros)/k;
+  q.resize(n + 1);
+  for(int j=0; j<=n; j++) q[j] = c[j*k];
+}
+
+// All k-th roots of the n roots y of q. Roots that are real are returned with an
+// imaginary part of exactly zero.
+inline void Structure::expandPowers(int n, const double* yr, const double* yi, int k, double* zr, double* zi) const {
+  const double pi = 3.14159265358979323846;
+  int l{0};
+  for(int j=0; j<n; j++) {
+    double r = std::pow(std::hypot(yr[j], yi[j]), 1.0/(double)k);
+    double theta = std::atan2(yi[j], yr[j]);
+    for(int m=0; m<k; m++) {
+      if(yi[j] == 0.0 && yr[j] >= 0.0 && (2*m == 0 || 2*m == k)) {
+        zr[l] = ((m == 0) ? r : -r);
+        zi[l] = 0.0;
+      }
+      else if(yi[j] == 0.0 && yr[j] < 0.0 && 2*m + 1 == k) {
+        zr[l] = -r;
+        zi[l] = 0.0;
+      }
+      else {
+        double phi = (theta + 2.0*pi*(double)m)/(double)k;
+        zr[l] = r*std::cos(phi);
+        zi[l] = r*std::sin(phi);
+      }
+      l++;
+    }
+  }
+}
+
+// +1 for palindromic, -1 for anti-palindromic, 0 otherwise
+inline int Structure::reciprocal(const std::vector<double>& c) const {
+  int N = c.size()-1;
+  bool pal{true}, anti{true};
+  for(int j=0; j<=N/2 && (pal || anti); j++) {
+    if(c[j] != c[N - j])  pal  = false;
+    if(c[j] != -c[N - j]) anti = false;
+  }
+  if(pal)  return 1;
+  if(anti) return -1;
+  return 0;
+}
+
+// Divide out the factors x-1 and x+1 implied by the symmetry, storing their roots in
+// zr, zi. q is the remaining even degree palindromic polynomial. Returns the number of
+// roots stored.
+inline int Structure::splitReciprocal(const std::vector<double>& c, int sign, std::vector<double>& q,
+                               double* zr, double* zi) const {
+  int nlin{0};
+  q = c;
+  for(;;) {
+    int N = q.size()-1;
+    double x;
+    if(sign < 0) {
+      x = 1.0;
+    }
+    else if(N % 2 == 1) {
+      x = -1.0;
+    }
+    else {
+      break;
+    }
+
+    // Synthetic division by x - root
+    std::vector<double> d(N);
+    d[0] = q[0];
+    for(int j=1; j<N; j++) d[j] = q[j] + x*d[j - 1];
+    // The quotient is palindromic; symmetrize away rounding
+    for(int j=0; j<N/2; j++) d[j] = d[N - 1 - j] = 0.5*(d[j] + d[N - 1 - j]);
+    q.swap(d);
+
+    zr[nlin] = x;
+    zi[nlin] = 0.0;
+    nlin++;
+    sign = 1;
+  }
+  return nlin;
+}
+
+// q(w) of degree m with p(x) = x^m q(x + 1/x), p palindromic of degree 2m
+inline void Structure::fold(const std::vector<double>& q, std::vector<double>& w) const {
+  int m = (q.size()-1)/2;
+  w.assign(m + 1, 0.0);
+  w[m] = q[m];
+
+  // s_k(w) = x^k + x^-k with s_0 = 2, s_1 = w, s_k = w s_(k-1) - s_(k-2), stored with
+  // the constant term first
+  std::vector<double> s0(1, 2.0), s1(2, 0.0), s2;
+  s1[1] = 1.0;
+  for(int k=1; k<=m; k++) {
+    for(int i=0; i<=k; i++) w[m - i] += q[m - k]*s1[i];
+    s2.assign(k + 2, 0.0);
+    for(int i=0; i<=k; i++) s2[i + 1] += s1[i];
+    for(int i=0; i<k; i++)  s2[i] -= s0[i];
+    s0.swap(s1);
+    s1.swap(s2);
+  }
+}
+
+// The two roots of x^2 - w x + 1 = 0 for each of the m roots w
+inline void Structure::unfold(int m, const double* wr, const double* wi, double* zr, double* zi) const {
+  for(int j=0; j<m; j++) {
+    double* xr = &zr[2*j];
+    double* xi = &zi[2*j];
+    if(wi[j] == 0.0) {
+      double w = wr[j];
+      double disc = w*w - 4.0;
+      if(disc >= 0.0) {
+        // Larger root directly, smaller as its reciprocal
+        double big = 0.5*(w + ((w >= 0.0) ? std::sqrt(disc) : -std::sqrt(disc)));
+        xr[0] = big;
+        xr[1] = 1.0/big;
+        xi[0] = xi[1] = 0.0;
+      }
+      else {
+        xr[0] = xr[1] = 0.5*w;
+        xi[0] = 0.5*std::sqrt(-disc);
+        xi[1] = -xi[0];
+      }
+    }
+    else {
+      std::complex<double> w(wr[j], wi[j]);
+      std::complex<double> d = std::sqrt(w*w - 4.0);
+      if(std::real(std::conj(w)*d) < 0.0) d = -d;
+      std::complex<double> big = 0.5*(w + d);
+      std::complex<double> small = 1.0/big;
+      xr[0] = std::real(big);
+      xi[0] = std::imag(big);
+      xr[1] = std::real(small);
+      xi[1] = std::imag(small);
+    }
+  }
+}
+
+#endif
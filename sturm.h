@@ -0,0 +1,126 @@
+#include "polyarith.h"
+
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+
+#ifndef SturmChain_h
+#define SturmChain_h
+
+// Number of distinct real roots in an interval by a Sturm chain, without computing them.
+//
+// The chain starts with p and p' and continues with the negated remainders of the
+// Euclidean algorithm, p_(k+1) = -(p_(k-1) mod p_k). If V(x) is the number of sign changes
+// in p_0(x), p_1(x), ..., the roots in (a, b] number V(a) - V(b). When p has multiple roots
+// the chain ends in their greatest common divisor g instead of a constant, and every
+// member is divided by g, so the chain is that of the square-free part and the count is
+// still exact where g vanishes.
+//
+// build costs O(N^2) once; a count is then two evaluations of the chain, O(N^2) simple
+// arithmetic without a solve. The chain is stored contiguously, member after member, so
+// that repeated queries on one polynomial stay in cache. Remainders at most tol relative to
+// their dividend are taken as zero, as in PolyArith::gcd.
+
+class SturmChain {
+  public:
+    SturmChain(double tol = 1.0e-10);
+    void build(const std::vector<double>& p);
+    bool matches(const std::vector<double>& p) const;
+    int variations(double x) const;
+    int count(double a, double b) const;
+
+  private:
+    PolyArith arith;
+    double tol;
+    std::vector<double> poly;
+    std::vector<double> coeff;
+    std::vector<int> start;
+
+    int sign(int k, double x) const;
+};
+
+inline SturmChain::SturmChain(double tol) : tol(tol) {}
+
+// True if the chain was built for p, so that it can be reused
+inline bool SturmChain::matches(const std::vector<double>& p) const {
+  return (!start.empty() && p == poly);
+}
+
+inline void SturmChain::build(const std::vector<double>& p) {
+  if(p.empty() || p[0] == 0.0) {
+    throw std::invalid_argument( "The leading coefficient is zero." );
+  }
+  poly = p;
+
+  std::vector<std::vector<double> > chain(1, p), q(1);
+  std::vector<double> r;
+  arith.derivative(p, r);
+  while(r.size() > 1 || r[0] != 0.0) {
+    // Positive scaling keeps the signs and the coefficients near one
+    double scale = arith.norm(r);
+    for(size_t j=0; j<r.size(); j++) r[j] /= scale;
+    chain.push_back(r);
+
+    const std::vector<double>& u = chain[chain.size() - 2];
+    arith.divide(u, chain.back(), q[0], r);
+    if(arith.norm(r) <= tol*arith.norm(u)) break;
+    arith.trim(r, tol);
+    for(size_t j=0; j<r.size(); j++) r[j] = -r[j];
+  }
+
+  // Divide out the common factor of multiple roots; its sign is the same in every member
+  std::vector<double> g = chain.back(), rem;
+  if(g.size() > 1) {
+    for(size_t k=0; k<chain.size(); k++) {
+      arith.divide(chain[k], g, q[0], rem);
+      chain[k] = q[0];
+    }
+  }
+
+  coeff.clear();
+  start.assign(1, 0);
+  for(size_t k=0; k<chain.size(); k++) {
+    coeff.insert(coeff.end(), chain[k].begin(), chain[k].end());
+    start.push_back(coeff.size());
+  }
+}
+
+// Sign of the k-th member at x, on the reversed polynomial in 1/x outside [-1, 1] so that
+// no power of x overflows; x may be infinite
+inline int SturmChain::sign(int k, double x) const {
+  const double* c = &coeff[start[k]];
+  int n = start[k + 1] - start[k] - 1;
+  double v;
+  if(fabs(x) <= 1.0) {
+    v = c[0];
+    for(int j=1; j<=n; j++) v = v*x + c[j];
+  }
+  else {
+    double y = 1.0/x;
+    v = c[n];
+    for(int j=n-1; j>=0; j--) v = v*y + c[j];
+    if((n & 1) && x < 0.0) v = -v;
+  }
+  return ((v > 0.0) ? 1 : ((v < 0.0) ? -1 : 0));
+}
+
+// Sign changes in the chain at x, zeros skipped
+inline int SturmChain::variations(double x) const {
+  int changes{0};
+  int last{0};
+  for(size_t k=0; k+1<start.size(); k++) {
+    int s = sign(k, x);
+    if(s == 0) continue;
+    if(last != 0 && s != last) changes++;
+    last = s;
+  }
+  return changes;
+}
+
+// Distinct real roots in the closed interval [a, b]; a and b may be infinite
+inline int SturmChain::count(double a, double b) const {
+  if(!(a <= b)) return 0;
+  return variations(a) - variations(b) + ((sign(0, a) == 0) ? 1 : 0);
+}
+
+#endif
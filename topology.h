@@ -0,0 +1,155 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+#ifndef NumaTopology_h
+#define NumaTopology_h
+
+// The NUMA nodes of the machine and the CPUs of each, for the placement of threads and
+// memory.
+//
+// detect reads /sys/devices/system/node; where that is missing, as on other systems, the
+// machine is one node of hardware_concurrency CPUs. simulated makes up nodes of the given
+// size, for tests on machines of a single node: its CPUs are mapped onto the CPUs the
+// process may run on, in turn, so that pinning works whatever the machine. single is one
+// node of the given number of threads that are not pinned at all.
+//
+// Memory is placed by first touch, the default policy of Linux: a page goes to the node of
+// the thread that first writes it. So a thread pinned to a CPU of a node allocates on that
+// node what it writes first, without libnuma.
+
+class NumaTopology {
+  public:
+    static NumaTopology detect(void);
+    static NumaTopology simulated(int nodes, int cpusPerNode);
+    static NumaTopology single(int threads);
+
+    int getNodes(void) const;
+    const std::vector<int>& getCpus(int node) const;
+    int getThreads(void) const;
+    bool isPinned(void) const;
+    bool pin(int cpu) const;
+
+  private:
+    std::vector<std::vector<int> > cpus;
+    bool pinned{true};
+    bool mapped{false};
+
+    static bool parse(const std::string& list, std::vector<int>& cpus);
+};
+
+// A list like 0-3,8,10-11
+inline bool NumaTopology::parse(const std::string& list, std::vector<int>& cpus) {
+  std::stringstream in(list);
+  std::string range;
+  while(std::getline(in, range, ',')) {
+    int a, b;
+    char dash;
+    std::stringstream r(range);
+    if(!(r >> a)) continue;
+    b = a;
+    if(r >> dash >> b) {
+      if(dash != '-') return false;
+    }
+    for(int c=a; c<=b; c++) cpus.push_back(c);
+  }
+  return !cpus.empty();
+}
+
+inline NumaTopology NumaTopology::detect(void) {
+  NumaTopology topology;
+  for(int node=0; ; node++) {
+    std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if(!in) break;
+    std::string list;
+    std::getline(in, list);
+    std::vector<int> cpus;
+    // Nodes of memory only have no CPUs and no threads
+    if(parse(list, cpus)) topology.cpus.push_back(cpus);
+  }
+  if(topology.cpus.empty()) {
+    topology = single(0);
+    topology.pinned = false;
+  }
+  return topology;
+}
+
+inline NumaTopology NumaTopology::simulated(int nodes, int cpusPerNode) {
+  if(nodes < 1 || cpusPerNode < 1) {
+    throw std::invalid_argument( "A topology needs at least one node of one CPU." );
+  }
+  NumaTopology topology;
+  topology.mapped = true;
+  for(int node=0; node<nodes; node++) {
+    topology.cpus.push_back(std::vector<int>());
+    for(int c=0; c<cpusPerNode; c++) topology.cpus.back().push_back(node*cpusPerNode + c);
+  }
+  return topology;
+}
+
+inline NumaTopology NumaTopology::single(int threads) {
+  if(threads <= 0)   threads = std::thread::hardware_concurrency();
+  if(threads <= 0)   threads = 1;
+  NumaTopology topology;
+  topology.pinned = false;
+  topology.cpus.push_back(std::vector<int>());
+  for(int c=0; c<threads; c++) topology.cpus.back().push_back(c);
+  return topology;
+}
+
+inline int NumaTopology::getNodes(void) const {
+  return cpus.size();
+}
+
+inline const std::vector<int>& NumaTopology::getCpus(int node) const {
+  return cpus[node];
+}
+
+inline int NumaTopology::getThreads(void) const {
+  int n{0};
+  for(size_t node=0; node<cpus.size(); node++) n += cpus[node].size();
+  return n;
+}
+
+inline bool NumaTopology::isPinned(void) const {
+  return pinned;
+}
+
+// Pins the calling thread to cpu; false if that is not possible here
+inline bool NumaTopology::pin(int cpu) const {
+#ifdef __linux__
+  if(!pinned) return false;
+  if(mapped) {
+    // The cpu-th of the CPUs allowed, round robin
+    cpu_set_t allowed;
+    if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return false;
+    int n = CPU_COUNT(&allowed);
+    if(n == 0) return false;
+    int k = cpu % n;
+    for(int c=0; c<CPU_SETSIZE; c++) {
+      if(CPU_ISSET(c, &allowed) && k-- == 0) {
+        cpu = c;
+        break;
+      }
+    }
+  }
+  if(cpu < 0 || cpu >= CPU_SETSIZE) return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+#endif
@@ -0,0 +1,501 @@
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <ostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#ifndef Tracer_h
+#define Tracer_h
+
+// Points of the solve that are traced
+enum class TracePoint {
+  FindRoots,
+  Rpoly,
+  Fxshfr,
+  QuadIT,
+  RealIT
+};
+
+// Trace of where the time of the solves goes, cheap enough to leave in a service.
+//
+// A TraceScope records the span of the block it lives in into a ring buffer of the thread,
+// and its time into counters of the thread: the spans and the seconds of each TracePoint,
+// and, for a scope given a backend, a histogram of the latency by backend and range of
+// degrees. Only the thread writes its ring and counters, with relaxed atomic stores and no
+// lock; the exports read them from another thread at any time. A ring keeps the last
+// RingSize spans of its thread; the export takes the last RingSize - 1 of them, as the
+// oldest slot may be the one being written, and skips those overwritten while it reads.
+//
+// Tracing is off until enable. Off, a scope costs the test of a flag; built
+// with ROOTS_NO_TRACE, nothing at all. writeChrome gives the spans in the ring buffers as
+// the JSON of chrome://tracing and Perfetto; writeMetrics gives the counters and the
+// histograms in the text format of Prometheus, and MetricsExporter writes them to a file
+// every so many seconds, for the textfile collector of node_exporter. The counters of a
+// thread that has ended are added to those kept for ended threads as it ends; its ring is
+// kept for writeChrome until DeadRings rings of threads that ended after it are.
+
+class Tracer {
+  public:
+    static const int RingSize = 1 << 13;
+    static const int DeadRings = 4;
+    static const int Points = 5;
+    static const int Backends = 8;
+    static const int DegreeBuckets = 20;
+    static const int LatencyBuckets = 16;
+
+    static void enable(bool on);
+    static bool isEnabled(void);
+    static void reset(void);
+    static void writeChrome(std::ostream& out);
+    static void writeMetrics(std::ostream& out);
+    static void saveChrome(const std::string& path);
+    static void saveMetrics(const std::string& path);
+    static const char* name(TracePoint point);
+
+    static std::uint64_t now(void);
+    static void record(TracePoint point, int degree, const char* backend, std::uint64_t start, std::uint64_t end);
+
+  private:
+    struct Counters {
+      std::atomic<std::uint64_t> spans[Points];
+      std::atomic<std::uint64_t> nanos[Points];
+      std::atomic<std::uint64_t> latency[Backends][DegreeBuckets][LatencyBuckets + 1];
+      std::atomic<std::uint64_t> sum[Backends][DegreeBuckets];
+      Counters(void) { clear(); }
+      void clear(void);
+      void add(const Counters& other);
+    };
+
+    struct Slot {
+      std::atomic<std::uint64_t> start;
+      std::atomic<std::uint64_t> end;
+      std::atomic<std::int32_t> point;
+      std::atomic<std::int32_t> degree;
+    };
+
+    struct Ring {
+      Slot slots[RingSize];
+      std::atomic<std::uint64_t> head{0};
+      std::atomic<bool> alive{true};
+      int tid;
+      Counters counters;
+    };
+
+    // Owned by the thread; marks the ring of a thread that has ended
+    struct Holder {
+      std::shared_ptr<Ring> ring;
+      Holder(void);
+      ~Holder(void);
+    };
+
+    struct State {
+      std::atomic<std::uint64_t> origin{0};
+      std::mutex lock;
+      std::vector<std::shared_ptr<Ring> > rings;
+      int threads{0};
+      std::atomic<const char*> backends[Backends];
+      std::atomic<int> backendCount{0};
+      // Of threads that have ended
+      Counters retired;
+      State(void) { for(int k=0; k<Backends; k++) backends[k] = nullptr; }
+    };
+
+    static State& state(void);
+    static void prune(State& s);
+    // Apart from State, so that testing it needs no guard of a static initialization
+    static std::atomic<bool>& on(void);
+    static Ring& ring(void);
+    static int backend(const char* name);
+    static int degreeBucket(int degree);
+    static int latencyBucket(std::uint64_t nanos);
+    static const double* bounds(void);
+    static void save(const std::string& path, void (*write)(std::ostream&));
+};
+
+// Records the span from its construction to the end of the block. With a backend, the
+// latency also goes into the histogram of that backend and the degree.
+class TraceScope {
+  public:
+    TraceScope(TracePoint point, int degree, const char* backend = nullptr);
+    ~TraceScope(void);
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+  private:
+#ifndef ROOTS_NO_TRACE
+    TracePoint point;
+    int degree;
+    const char* backend;
+    std::uint64_t start;
+#endif
+};
+
+// Writes the metrics to path every period seconds, and once more when destroyed. Each
+// write goes to a temporary file renamed over path, so that a reader never sees half.
+class MetricsExporter {
+  public:
+    MetricsExporter(const std::string& path, double period);
+    ~MetricsExporter(void);
+
+  private:
+    std::string path;
+    double period;
+    bool done{false};
+    std::mutex lock;
+    std::condition_variable wake;
+    std::thread thread;
+
+    void run(void);
+};
+
+inline void Tracer::Counters::clear(void) {
+  for(int p=0; p<Points; p++) spans[p] = nanos[p] = 0;
+  for(int b=0; b<Backends; b++) {
+    for(int d=0; d<DegreeBuckets; d++) {
+      for(int l=0; l<=LatencyBuckets; l++) latency[b][d][l] = 0;
+      sum[b][d] = 0;
+    }
+  }
+}
+
+inline void Tracer::Counters::add(const Counters& other) {
+  for(int p=0; p<Points; p++) {
+    spans[p].fetch_add(other.spans[p].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    nanos[p].fetch_add(other.nanos[p].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+  for(int b=0; b<Backends; b++) {
+    for(int d=0; d<DegreeBuckets; d++) {
+      for(int l=0; l<=LatencyBuckets; l++) {
+        latency[b][d][l].fetch_add(other.latency[b][d][l].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+      sum[b][d].fetch_add(other.sum[b][d].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+  }
+}
+
+inline Tracer::Holder::Holder(void) : ring(new Ring) {
+  State& s = state();
+  std::lock_guard<std::mutex> guard(s.lock);
+  ring->tid = ++s.threads;
+  s.rings.push_back(ring);
+}
+
+inline Tracer::Holder::~Holder(void) {
+  State& s = state();
+  std::lock_guard<std::mutex> guard(s.lock);
+  s.retired.add(ring->counters);
+  ring->alive.store(false, std::memory_order_release);
+  prune(s);
+}
+
+// Drops all but the last DeadRings rings of ended threads; under the lock of the state
+inline void Tracer::prune(State& s) {
+  int dead{0};
+  for(size_t k=s.rings.size(); k-->0; ) {
+    if(!s.rings[k]->alive.load(std::memory_order_acquire) && ++dead > DeadRings) {
+      s.rings.erase(s.rings.begin() + k);
+    }
+  }
+}
+
+inline Tracer::State& Tracer::state(void) {
+  static State s;
+  return s;
+}
+
+inline std::atomic<bool>& Tracer::on(void) {
+  static std::atomic<bool> flag{false};
+  return flag;
+}
+
+inline Tracer::Ring& Tracer::ring(void) {
+  static thread_local Holder holder;
+  return *holder.ring;
+}
+
+inline void Tracer::enable(bool on) {
+  State& s = state();
+  std::uint64_t zero{0};
+  s.origin.compare_exchange_strong(zero, now());
+  Tracer::on().store(on, std::memory_order_relaxed);
+}
+
+inline bool Tracer::isEnabled(void) {
+  return on().load(std::memory_order_relaxed);
+}
+
+// Empties the rings and zeroes the counters; for tests, while no thread traces
+inline void Tracer::reset(void) {
+  State& s = state();
+  std::lock_guard<std::mutex> guard(s.lock);
+  for(size_t r=0; r<s.rings.size(); r++) {
+    s.rings[r]->head = 0;
+    s.rings[r]->counters.clear();
+  }
+  s.retired.clear();
+}
+
+inline const char* Tracer::name(TracePoint point) {
+  static const char* names[Points] = {"findRoots", "rpoly", "Fxshfr", "QuadIT", "RealIT"};
+  return names[(int)point];
+}
+
+inline std::uint64_t Tracer::now(void) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Index of the backend, registered the first time it is seen; the last one takes those
+// beyond Backends
+inline int Tracer::backend(const char* name) {
+  State& s = state();
+  int n = s.backendCount.load(std::memory_order_acquire);
+  for(int k=0; k<n; k++) {
+    const char* known = s.backends[k].load(std::memory_order_relaxed);
+    if(known == name || std::strcmp(known, name) == 0) return k;
+  }
+  std::lock_guard<std::mutex> guard(s.lock);
+  n = s.backendCount.load(std::memory_order_relaxed);
+  for(int k=0; k<n; k++) {
+    if(std::strcmp(s.backends[k].load(std::memory_order_relaxed), name) == 0) return k;
+  }
+  if(n == Backends) return Backends - 1;
+  s.backends[n].store((n == Backends - 1) ? "other" : name, std::memory_order_relaxed);
+  s.backendCount.store(n + 1, std::memory_order_release);
+  return n;
+}
+
+// Degrees [2^d, 2^(d+1))
+inline int Tracer::degreeBucket(int degree) {
+  int d{0};
+  for(; degree > 1 && d < DegreeBuckets - 1; degree >>= 1) d++;
+  return d;
+}
+
+// Upper bounds of the latency buckets in seconds, the last one +Inf
+inline const double* Tracer::bounds(void) {
+  static const double le[LatencyBuckets] = {1.0e-6, 2.5e-6, 5.0e-6, 1.0e-5, 2.5e-5, 5.0e-5, 1.0e-4, 2.5e-4,
+                                           5.0e-4, 1.0e-3, 2.5e-3, 5.0e-3, 1.0e-2, 2.5e-2, 0.1, 1.0};
+  return le;
+}
+
+inline int Tracer::latencyBucket(std::uint64_t nanos) {
+  const double* le = bounds();
+  double seconds = nanos*1.0e-9;
+  int l{0};
+  while(l < LatencyBuckets && seconds > le[l]) l++;
+  return l;
+}
+
+inline void Tracer::record(TracePoint point, int degree, const char* backend, std::uint64_t start, std::uint64_t end) {
+  Ring& r = ring();
+  int p = (int)point;
+  std::uint64_t nanos = end - start;
+  r.counters.spans[p].store(r.counters.spans[p].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  r.counters.nanos[p].store(r.counters.nanos[p].load(std::memory_order_relaxed) + nanos, std::memory_order_relaxed);
+  if(backend != nullptr) {
+    int b = Tracer::backend(backend), d = degreeBucket(degree);
+    std::atomic<std::uint64_t>& count = r.counters.latency[b][d][latencyBucket(nanos)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    r.counters.sum[b][d].store(r.counters.sum[b][d].load(std::memory_order_relaxed) + nanos, std::memory_order_relaxed);
+  }
+
+  // The head of the last span is published before the slot is overwritten, so a reader
+  // that sees the new contents also sees the head that marks the old ones as gone
+  std::uint64_t h = r.head.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  Slot& slot = r.slots[h % RingSize];
+  slot.start.store(start, std::memory_order_relaxed);
+  slot.end.store(end, std::memory_order_relaxed);
+  slot.point.store(p, std::memory_order_relaxed);
+  slot.degree.store(degree, std::memory_order_relaxed);
+  r.head.store(h + 1, std::memory_order_release);
+}
+
+inline void Tracer::writeChrome(std::ostream& out) {
+  State& s = state();
+  std::vector<std::shared_ptr<Ring> > rings;
+  {
+    std::lock_guard<std::mutex> guard(s.lock);
+    prune(s);
+    rings = s.rings;
+  }
+  std::uint64_t origin = s.origin.load(std::memory_order_relaxed);
+  int pid = getpid();
+
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  for(size_t k=0; k<rings.size(); k++) {
+    Ring& r = *rings[k];
+    std::uint64_t h = r.head.load(std::memory_order_acquire);
+    std::uint64_t from = ((h > (std::uint64_t)RingSize) ? h - RingSize : 0);
+    std::vector<std::uint64_t> start, end;
+    std::vector<std::int32_t> point, degree;
+    for(std::uint64_t i=from; i<h; i++) {
+      const Slot& slot = r.slots[i % RingSize];
+      start.push_back(slot.start.load(std::memory_order_relaxed));
+      end.push_back(slot.end.load(std::memory_order_relaxed));
+      point.push_back(slot.point.load(std::memory_order_relaxed));
+      degree.push_back(slot.degree.load(std::memory_order_relaxed));
+    }
+    // Spans at or below the new head less RingSize may have been overwritten meanwhile
+    std::atomic_thread_fence(std::memory_order_acquire);
+    std::uint64_t h2 = r.head.load(std::memory_order_relaxed);
+    for(std::uint64_t i=from; i<h; i++) {
+      if(h2 >= (std::uint64_t)RingSize && i <= h2 - RingSize) continue;
+      size_t j = i - from;
+      if(point[j] < 0 || point[j] >= Points) continue;
+      out << (first ? "\n" : ",\n");
+      first = false;
+      char times[64];
+      std::snprintf(times, sizeof(times), "\"ts\":%.3f,\"dur\":%.3f", (start[j] - origin)*1.0e-3, (end[j] - start[j])*1.0e-3);
+      out << "{\"name\":\"" << name((TracePoint)point[j]) << "\",\"cat\":\"roots\",\"ph\":\"X\",\"pid\":" << pid
+          << ",\"tid\":" << r.tid << "," << times
+          << ",\"args\":{\"degree\":" << degree[j] << "}}";
+    }
+  }
+  out << "\n]}\n";
+}
+
+inline void Tracer::writeMetrics(std::ostream& out) {
+  State& s = state();
+  std::unique_ptr<Counters> total(new Counters);
+  std::vector<const char*> backends;
+  {
+    std::lock_guard<std::mutex> guard(s.lock);
+    // Those of ended threads are in retired already
+    for(size_t k=0; k<s.rings.size(); k++) {
+      if(s.rings[k]->alive.load(std::memory_order_acquire))   total->add(s.rings[k]->counters);
+    }
+    total->add(s.retired);
+    for(int k=0; k<s.backendCount.load(std::memory_order_acquire); k++) backends.push_back(s.backends[k]);
+  }
+
+  out << "# HELP roots_trace_spans_total Spans recorded at each trace point.\n";
+  out << "# TYPE roots_trace_spans_total counter\n";
+  for(int p=0; p<Points; p++) {
+    out << "roots_trace_spans_total{point=\"" << name((TracePoint)p) << "\"} " << total->spans[p] << "\n";
+  }
+  std::streamsize precision = out.precision(9);
+  out << "# HELP roots_trace_seconds_total Time spent in each trace point, nested points included.\n";
+  out << "# TYPE roots_trace_seconds_total counter\n";
+  for(int p=0; p<Points; p++) {
+    out << "roots_trace_seconds_total{point=\"" << name((TracePoint)p) << "\"} " << total->nanos[p]*1.0e-9 << "\n";
+  }
+
+  const double* le = bounds();
+  out << "# HELP roots_solve_seconds Latency of the solves by backend and range of degrees.\n";
+  out << "# TYPE roots_solve_seconds histogram\n";
+  for(size_t b=0; b<backends.size(); b++) {
+    for(int d=0; d<DegreeBuckets; d++) {
+      std::uint64_t count{0};
+      for(int l=0; l<=LatencyBuckets; l++) count += total->latency[b][d][l];
+      if(count == 0) continue;
+      std::ostringstream labels;
+      labels << "backend=\"" << backends[b] << "\",degree=\"" << (1 << d);
+      if(d > 0)   labels << "-" << (2 << d) - 1;
+      labels << "\"";
+      std::uint64_t cumulative{0};
+      for(int l=0; l<=LatencyBuckets; l++) {
+        cumulative += total->latency[b][d][l];
+        out << "roots_solve_seconds_bucket{" << labels.str() << ",le=\"";
+        if(l < LatencyBuckets)   out << le[l];
+        else out << "+Inf";
+        out << "\"} " << cumulative << "\n";
+      }
+      out << "roots_solve_seconds_sum{" << labels.str() << "} " << total->sum[b][d]*1.0e-9 << "\n";
+      out << "roots_solve_seconds_count{" << labels.str() << "} " << count << "\n";
+    }
+  }
+  out.precision(precision);
+}
+
+inline void Tracer::save(const std::string& path, void (*write)(std::ostream&)) {
+  std::string temporary = path + ".tmp";
+  {
+    std::ofstream out(temporary.c_str());
+    if(!out) {
+      throw std::runtime_error( "The trace file could not be opened: " + temporary );
+    }
+    write(out);
+    if(!out) {
+      throw std::runtime_error( "The trace file could not be written: " + temporary );
+    }
+  }
+  if(std::rename(temporary.c_str(), path.c_str()) != 0) {
+    throw std::runtime_error( "The trace file could not be renamed to " + path );
+  }
+}
+
+inline void Tracer::saveChrome(const std::string& path) {
+  save(path, &Tracer::writeChrome);
+}
+
+inline void Tracer::saveMetrics(const std::string& path) {
+  save(path, &Tracer::writeMetrics);
+}
+
+#ifndef ROOTS_NO_TRACE
+
+inline TraceScope::TraceScope(TracePoint point, int degree, const char* backend)
+  : point(point), degree(degree), backend(backend), start(0) {
+  if(Tracer::isEnabled())   start = Tracer::now();
+}
+
+inline TraceScope::~TraceScope(void) {
+  if(start == 0) return;
+  try {
+    Tracer::record(point, degree, backend, start, Tracer::now());
+  }
+  catch (...) {
+    // No memory for the ring of the thread: the span is lost
+  }
+}
+
+#else
+
+inline TraceScope::TraceScope(TracePoint, int, const char*) {}
+
+inline TraceScope::~TraceScope(void) {}
+
+#endif
+
+inline MetricsExporter::MetricsExporter(const std::string& path, double period) : path(path), period(period) {
+  thread = std::thread(&MetricsExporter::run, this);
+}
+
+inline MetricsExporter::~MetricsExporter(void) {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    done = true;
+  }
+  wake.notify_one();
+  thread.join();
+}
+
+inline void MetricsExporter::run(void) {
+  std::unique_lock<std::mutex> guard(lock);
+  for(;;) {
+    bool last = wake.wait_for(guard, std::chrono::duration<double>(period), [this]() { return done; });
+    try {
+      Tracer::saveMetrics(path);
+    }
+    catch (const std::exception&) {
+      // The next period tries again
+    }
+    if(last) return;
+  }
+}
+
+#endif
@@ -0,0 +1,140 @@
+#include "gmock/gmock.h"
+
+#include "trace.h"
+#include "akiti.h"
+#include "roots.h"
+
+#include <vector>
+#include <thread>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <unistd.h>
+
+using namespace testing;
+
+class Trace: public Test {
+  public:
+    // (x - 1)(x - 2)(x - 3)(x^2 + 1)
+    std::vector<double> coeff = {1.0, -6.0, 12.0, -12.0, 11.0, -6.0};
+
+    void SetUp() override {
+      Tracer::reset();
+      Tracer::enable(true);
+    }
+
+    void TearDown() override {
+      Tracer::enable(false);
+    }
+
+    std::string chrome(void) {
+      std::ostringstream out;
+      Tracer::writeChrome(out);
+      return out.str();
+    }
+
+    std::string metrics(void) {
+      std::ostringstream out;
+      Tracer::writeMetrics(out);
+      return out.str();
+    }
+
+    int count(const std::string& text, const std::string& what) {
+      int n{0};
+      for(size_t at=text.find(what); at!=std::string::npos; at=text.find(what, at + 1)) n++;
+      return n;
+    }
+};
+
+TEST_F(Trace, SolveRecordsEveryTracePoint) {
+  Akiti akiti(10);
+  Roots rootfinder(&akiti);
+  rootfinder.findRoots(coeff);
+
+  std::string m = metrics();
+  ASSERT_THAT(count(m, "roots_trace_spans_total{point=\"findRoots\"} 1\n"), Eq(1));
+  ASSERT_THAT(count(m, "roots_trace_spans_total{point=\"rpoly\"} 1\n"), Eq(1));
+  ASSERT_THAT(count(m, "roots_trace_spans_total{point=\"Fxshfr\"} 0\n"), Eq(0));
+  ASSERT_THAT(count(m, "roots_solve_seconds_count{backend=\"akiti\",degree=\"4-7\"} 1\n"), Eq(1));
+  ASSERT_THAT(count(m, "roots_solve_seconds_bucket{backend=\"akiti\",degree=\"4-7\",le=\"+Inf\"} 1\n"), Eq(1));
+
+  std::string c = chrome();
+  ASSERT_THAT(c.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), Eq(0u));
+  ASSERT_THAT(count(c, "\"name\":\"findRoots\""), Eq(1));
+  ASSERT_THAT(count(c, "\"name\":\"Fxshfr\""), Ge(1));
+  ASSERT_THAT(count(c, "\"name\":\"QuadIT\"") + count(c, "\"name\":\"RealIT\""), Ge(1));
+  ASSERT_THAT(count(c, "\"args\":{\"degree\":5}"), Ge(2));
+}
+
+TEST_F(Trace, DisabledRecordsNothing) {
+  Tracer::enable(false);
+  Akiti akiti(10);
+  Roots rootfinder(&akiti);
+  rootfinder.findRoots(coeff);
+
+  ASSERT_THAT(count(chrome(), "\"ph\":\"X\""), Eq(0));
+  ASSERT_THAT(count(metrics(), "roots_solve_seconds_count"), Eq(0));
+}
+
+TEST_F(Trace, ThreadsThatEndedKeepTheirCounters) {
+  std::vector<std::thread> threads;
+  for(int t=0; t<3; t++) {
+    threads.push_back(std::thread([this]() {
+      Akiti akiti(10);
+      Roots rootfinder(&akiti);
+      int found;
+      for(int j=0; j<4; j++) rootfinder.solve(coeff, found);
+    }));
+  }
+  for(int t=0; t<3; t++) threads[t].join();
+
+  ASSERT_THAT(count(metrics(), "roots_trace_spans_total{point=\"findRoots\"} 12\n"), Eq(1));
+  ASSERT_THAT(count(metrics(), "roots_solve_seconds_count{backend=\"akiti\",degree=\"4-7\"} 12\n"), Eq(1));
+}
+
+TEST_F(Trace, RingKeepsTheLastSpans) {
+  std::thread writer([]() {
+    std::uint64_t t = Tracer::now();
+    for(int j=0; j<Tracer::RingSize + 100; j++) Tracer::record(TracePoint::QuadIT, j, nullptr, t + j, t + j + 1);
+  });
+  writer.join();
+
+  std::string c = chrome();
+  ASSERT_THAT(count(c, "\"name\":\"QuadIT\""), Eq(Tracer::RingSize - 1));
+  ASSERT_THAT(count(c, "\"args\":{\"degree\":100}"), Eq(0));
+  ASSERT_THAT(count(c, "\"args\":{\"degree\":101}"), Eq(1));
+}
+
+TEST_F(Trace, OnlyTheLastRingsOfEndedThreadsAreKept) {
+  for(int t=0; t<10; t++) {
+    std::thread writer([t]() {
+      std::uint64_t s = Tracer::now();
+      Tracer::record(TracePoint::RealIT, 1000 + t, nullptr, s, s + 1);
+    });
+    writer.join();
+  }
+
+  std::string c = chrome();
+  for(int t=0; t<10; t++) {
+    std::string span = "\"args\":{\"degree\":" + std::to_string(1000 + t) + "}";
+    ASSERT_THAT(count(c, span), Eq((t >= 10 - Tracer::DeadRings) ? 1 : 0));
+  }
+  ASSERT_THAT(count(metrics(), "roots_trace_spans_total{point=\"RealIT\"} 10\n"), Eq(1));
+}
+
+TEST_F(Trace, ExporterWritesTheMetricsFile) {
+  std::string path = "/tmp/rootstrace-" + std::to_string(getpid()) + ".prom";
+  {
+    MetricsExporter exporter(path, 0.01);
+    Akiti akiti(10);
+    Roots rootfinder(&akiti);
+    rootfinder.findRoots(coeff);
+  }
+  std::ifstream in(path.c_str());
+  std::stringstream text;
+  text << in.rdbuf();
+  std::remove(path.c_str());
+  ASSERT_THAT(count(text.str(), "# TYPE roots_solve_seconds histogram\n"), Eq(1));
+  ASSERT_THAT(count(text.str(), "roots_solve_seconds_count{backend=\"akiti\",degree=\"4-7\"} 1\n"), Eq(1));
+}